@@ -0,0 +1,320 @@
+/**
+ * @file AsyncLogger.cpp
+ * @brief Implementation of the asynchronous simulation log.
+ *
+ * This file implements the lock-free record ring filled by the
+ * simulation thread and the background thread that formats records
+ * and writes them to the log file in large blocks.
+ */
+
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+/** Size of the writer thread's output buffer */
+static const size_t WRITE_BUFFER_BYTES = 1 << 20;
+
+/**
+ * @brief Writes a whole buffer to a file descriptor.
+ *
+ * @param fd Open file descriptor.
+ * @param data Bytes to write.
+ * @param size Number of bytes.
+ */
+static void writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+/**
+ * @brief Constructs a logger that is not yet attached to a file.
+ *
+ * @param capacity Number of records the ring holds; rounded up to a power of two.
+ */
+AsyncLogger::AsyncLogger(size_t capacity)
+    : head(0),
+      tail(0),
+      stopping(false),
+      fd(-1),
+      level(LogLevel::State),
+      sampleEvery(1),
+      sampleCounter(0),
+      lastStateKept(false)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    ring.reset(new Record[size]);
+    mask = size - 1;
+}
+
+/**
+ * @brief Flushes and closes the log.
+ */
+AsyncLogger::~AsyncLogger() {
+    close();
+}
+
+/**
+ * @brief Creates or truncates the log file and starts the writer thread.
+ *
+ * @param path Path of the log file.
+ * @return true if the file was opened.
+ */
+bool AsyncLogger::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    stopping.store(false);
+    writer = std::thread(&AsyncLogger::writerLoop, this);
+    return true;
+}
+
+/**
+ * @brief Writes everything still queued and stops the writer thread.
+ */
+void AsyncLogger::close() {
+    if (writer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        writer.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+/**
+ * @brief Sets which records are kept.
+ *
+ * @param newLevel Most detailed level to record.
+ */
+void AsyncLogger::setLevel(LogLevel newLevel) {
+    level = newLevel;
+}
+
+/**
+ * @brief Keeps only one of every n state records.
+ *
+ * @param n Sampling interval; 1 keeps every record.
+ */
+void AsyncLogger::setSampling(int n) {
+    sampleEvery = n < 1 ? 1 : n;
+    sampleCounter = 0;
+}
+
+/**
+ * @brief Appends a record to the ring, waiting if the ring is full.
+ *
+ * Records are dropped if no file is open.
+ *
+ * @param record Record to append.
+ */
+void AsyncLogger::push(const Record& record) {
+    if (fd < 0) {
+        return;
+    }
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (pos - tail.load(std::memory_order_acquire) > mask) {
+        std::this_thread::yield();
+    }
+    ring[pos & mask] = record;
+    head.store(pos + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Logs text verbatim, regardless of level.
+ *
+ * @param line Text to write, including any newlines.
+ */
+void AsyncLogger::text(const std::string& line) {
+    Record record;
+    record.kind = TEXT;
+    record.cycle = 0;
+    for (size_t pos = 0; pos < line.size(); pos += TEXT_BYTES) {
+        size_t length = std::min(TEXT_BYTES, line.size() - pos);
+        record.length = static_cast<uint8_t>(length);
+        std::memcpy(record.text, line.data() + pos, length);
+        push(record);
+    }
+}
+
+/**
+ * @brief Logs the periodic system state.
+ *
+ * @param cycle Current clock cycle.
+ * @param servers Number of servers.
+ * @param queue Request queue length.
+ * @param processed Requests processed so far.
+ * @param blocked Requests blocked so far.
+ */
+void AsyncLogger::state(int cycle, int servers, size_t queue, int processed, int blocked) {
+    lastStateKept = level >= LogLevel::State && sampleCounter++ % sampleEvery == 0;
+    if (!lastStateKept) {
+        return;
+    }
+
+    Record record;
+    record.kind = STATE;
+    record.length = 0;
+    record.cycle = cycle;
+    record.state.servers = servers;
+    record.state.processed = processed;
+    record.state.blocked = blocked;
+    record.state.queue = queue;
+    push(record);
+}
+
+/**
+ * @brief Logs latency percentiles for the interval just ended.
+ *
+ * @param endToEnd True for arrival-to-completion latency, false for queue wait.
+ * @param percentiles p50, p90, p99 and p99.9 for all, streaming and processing jobs.
+ */
+void AsyncLogger::latency(bool endToEnd, const uint32_t percentiles[3][4]) {
+    if (!lastStateKept) {
+        return;
+    }
+
+    Record record;
+    record.kind = LATENCY;
+    record.length = endToEnd ? 1 : 0;
+    record.cycle = 0;
+    std::memcpy(record.latency.percentiles, percentiles, sizeof(record.latency.percentiles));
+    push(record);
+}
+
+/**
+ * @brief Logs servers being added or removed.
+ *
+ * @param cycle Current clock cycle.
+ * @param up True for scale-up, false for scale-down.
+ * @param servers Number of servers after the change.
+ * @param count Number of servers added or removed.
+ * @param pool Name of the pool that changed, or nullptr for a single pool;
+ *        names longer than 15 characters are cut short.
+ * @param poolServers Number of servers in that pool after the change.
+ */
+void AsyncLogger::scale(int cycle, bool up, int servers, int count,
+                        const char* pool, int poolServers) {
+    if (level < LogLevel::Scaling) {
+        return;
+    }
+
+    Record record;
+    record.kind = up ? SCALE_UP : SCALE_DOWN;
+    record.length = 0;
+    record.cycle = cycle;
+    record.state.servers = servers;
+    record.state.processed = count;
+    record.state.blocked = poolServers;
+    record.state.pool[0] = '\0';
+    if (pool) {
+        std::strncat(record.state.pool, pool, sizeof(record.state.pool) - 1);
+    }
+    push(record);
+}
+
+/**
+ * @brief Formats one record as text.
+ *
+ * @param record Record to format.
+ * @param out Destination with room for at least 256 bytes.
+ * @return Number of bytes written.
+ */
+size_t AsyncLogger::format(const Record& record, char* out) {
+    int n = 0;
+    switch (record.kind) {
+    case TEXT:
+        std::memcpy(out, record.text, record.length);
+        return record.length;
+    case STATE:
+        n = std::snprintf(out, 256,
+                          "[Cycle %d] Servers: %d, Queue: %llu, Processed: %d, Blocked: %d\n",
+                          record.cycle, record.state.servers,
+                          static_cast<unsigned long long>(record.state.queue),
+                          record.state.processed, record.state.blocked);
+        break;
+    case SCALE_UP:
+    case SCALE_DOWN: {
+        bool up = record.kind == SCALE_UP;
+        int count = record.state.processed;
+        if (count == 1) {
+            n = std::snprintf(out, 256, "[Cycle %d] SCALE %s: %s server. Total servers = %d",
+                              record.cycle, up ? "UP" : "DOWN", up ? "Added" : "Removed",
+                              record.state.servers);
+        } else {
+            n = std::snprintf(out, 256, "[Cycle %d] SCALE %s: %s %d servers. Total servers = %d",
+                              record.cycle, up ? "UP" : "DOWN", up ? "Added" : "Removed",
+                              count, record.state.servers);
+        }
+        if (record.state.pool[0] != '\0') {
+            n += std::snprintf(out + n, 256 - n, ", %s = %d", record.state.pool, record.state.blocked);
+        }
+        out[n++] = '\n';
+        break;
+    }
+    case LATENCY: {
+        const uint32_t (*p)[4] = record.latency.percentiles;
+        n = std::snprintf(out, 256,
+                          "  %s p50/p90/p99/p99.9: all %u/%u/%u/%u"
+                          ", streaming %u/%u/%u/%u, processing %u/%u/%u/%u\n",
+                          record.length ? "Latency" : "Wait   ",
+                          p[0][0], p[0][1], p[0][2], p[0][3],
+                          p[1][0], p[1][1], p[1][2], p[1][3],
+                          p[2][0], p[2][1], p[2][2], p[2][3]);
+        break;
+    }
+    }
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+/**
+ * @brief Background loop that drains the ring into the file.
+ *
+ * Formats records into a 1 MB buffer and writes it when it fills up,
+ * or whenever the ring runs dry so the file stays current. Exits once
+ * close() has been called and the ring is empty.
+ */
+void AsyncLogger::writerLoop() {
+    std::vector<char> buffer(WRITE_BUFFER_BYTES);
+    size_t used = 0;
+
+    while (true) {
+        bool stop = stopping.load(std::memory_order_acquire);
+        size_t pos = tail.load(std::memory_order_relaxed);
+        size_t end = head.load(std::memory_order_acquire);
+
+        for (; pos != end; pos++) {
+            if (used + 256 > buffer.size()) {
+                writeAll(fd, buffer.data(), used);
+                used = 0;
+            }
+            used += format(ring[pos & mask], buffer.data() + used);
+            tail.store(pos + 1, std::memory_order_release);
+        }
+
+        if (used > 0) {
+            writeAll(fd, buffer.data(), used);
+            used = 0;
+        }
+        if (stop) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,191 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * @brief How much detail the simulation log records.
+ */
+enum class LogLevel {
+    Quiet = 0,    ///< Start and end banners only
+    Scaling = 1,  ///< Also scale-up and scale-down events
+    State = 2     ///< Also the periodic state lines
+};
+
+/**
+ * @brief Asynchronous, buffered writer for the simulation log.
+ *
+ * The simulation thread appends fixed-size binary records to a
+ * single-producer/single-consumer lock-free ring. A background thread
+ * formats them as text into a large buffer and writes it to the file
+ * with one write() call per buffer, so the simulation never waits on
+ * iostream formatting or file I/O. Records below the configured level
+ * are dropped before they reach the ring, and state records can be
+ * sampled to one in every N.
+ */
+class AsyncLogger {
+private:
+    /** Kinds of log records */
+    enum RecordKind : uint8_t { TEXT, STATE, SCALE_UP, SCALE_DOWN, LATENCY };
+
+    /** Payload bytes a TEXT record can carry */
+    static constexpr size_t TEXT_BYTES = 48;
+
+    /** Counters carried by STATE and SCALE records */
+    struct StateFields {
+        int32_t servers;
+        int32_t processed;
+        int32_t blocked;
+        uint64_t queue;
+        char pool[16];
+    };
+
+    /** Percentiles carried by LATENCY records: all, streaming, processing */
+    struct LatencyFields {
+        uint32_t percentiles[3][4];
+    };
+
+    /** One fixed-size log record */
+    struct Record {
+        RecordKind kind;
+        uint8_t length;
+        int32_t cycle;
+        union {
+            StateFields state;
+            LatencyFields latency;
+            char text[TEXT_BYTES];
+        };
+    };
+
+    std::unique_ptr<Record[]> ring;
+    size_t mask;
+
+    /** Next slot the simulation thread writes, on its own cache line */
+    alignas(64) std::atomic<size_t> head;
+
+    /** Next slot the writer thread reads, on its own cache line */
+    alignas(64) std::atomic<size_t> tail;
+
+    std::thread writer;
+    std::atomic<bool> stopping;
+    int fd;
+    LogLevel level;
+    int sampleEvery;
+    int sampleCounter;
+    bool lastStateKept;
+
+    /**
+     * @brief Appends a record to the ring, waiting if the ring is full.
+     */
+    void push(const Record& record);
+
+    /**
+     * @brief Formats one record as text.
+     *
+     * @param record Record to format
+     * @param out Destination with room for at least 256 bytes
+     * @return Number of bytes written
+     */
+    static size_t format(const Record& record, char* out);
+
+    /**
+     * @brief Background loop that drains the ring into the file.
+     */
+    void writerLoop();
+
+public:
+    /**
+     * @brief Constructs a logger that is not yet attached to a file.
+     *
+     * @param capacity Number of records the ring holds before the
+     *        simulation thread has to wait
+     */
+    explicit AsyncLogger(size_t capacity = 1 << 16);
+
+    /**
+     * @brief Flushes and closes the log.
+     */
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief Creates or truncates the log file and starts the writer thread.
+     *
+     * @param path Path of the log file
+     * @return true if the file was opened
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Writes everything still queued and stops the writer thread.
+     */
+    void close();
+
+    /**
+     * @brief Sets which records are kept.
+     *
+     * @param newLevel Most detailed level to record
+     */
+    void setLevel(LogLevel newLevel);
+
+    /**
+     * @brief Keeps only one of every n state records.
+     *
+     * @param n Sampling interval; 1 keeps every record
+     */
+    void setSampling(int n);
+
+    /**
+     * @brief Logs text verbatim, regardless of level.
+     *
+     * Meant for banners written once per run; long text is split across
+     * several records.
+     *
+     * @param line Text to write, including any newlines
+     */
+    void text(const std::string& line);
+
+    /**
+     * @brief Logs the periodic system state.
+     *
+     * @param cycle Current clock cycle
+     * @param servers Number of servers
+     * @param queue Request queue length
+     * @param processed Requests processed so far
+     * @param blocked Requests blocked so far
+     */
+    void state(int cycle, int servers, size_t queue, int processed, int blocked);
+
+    /**
+     * @brief Logs latency percentiles for the interval just ended.
+     *
+     * Kept only if the state line for the same interval was kept.
+     *
+     * @param endToEnd True for arrival-to-completion latency, false for queue wait
+     * @param percentiles p50, p90, p99 and p99.9 for all, streaming and
+     *        processing jobs, in that order
+     */
+    void latency(bool endToEnd, const uint32_t percentiles[3][4]);
+
+    /**
+     * @brief Logs servers being added or removed.
+     *
+     * @param cycle Current clock cycle
+     * @param up True for scale-up, false for scale-down
+     * @param servers Number of servers after the change
+     * @param count Number of servers added or removed
+     * @param pool Name of the pool that changed, or nullptr for a single pool
+     * @param poolServers Number of servers in that pool after the change
+     */
+    void scale(int cycle, bool up, int servers, int count = 1,
+               const char* pool = nullptr, int poolServers = 0);
+};
+
+#endif // ASYNCLOGGER_H
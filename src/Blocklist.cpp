@@ -0,0 +1,181 @@
+/**
+ * @file Blocklist.cpp
+ * @brief Implementation of the CIDR blocklist.
+ *
+ * This file implements loading CIDR prefixes, compiling them into a
+ * sorted interval table and looking up packed IPv4 addresses.
+ */
+
+#include "Blocklist.h"
+#include "Request.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <numeric>
+
+/**
+ * @brief Constructs an empty blocklist.
+ */
+Blocklist::Blocklist()
+    : compiled(true)
+{
+}
+
+/**
+ * @brief Removes every range.
+ */
+void Blocklist::clear() {
+    starts.clear();
+    ends.clear();
+    compiled = true;
+}
+
+/**
+ * @brief Adds an inclusive range of addresses.
+ *
+ * @param first First blocked address (packed IPv4).
+ * @param last Last blocked address (packed IPv4).
+ */
+void Blocklist::addRange(uint32_t first, uint32_t last) {
+    if (first > last) {
+        std::swap(first, last);
+    }
+    starts.push_back(first);
+    ends.push_back(last);
+    compiled = false;
+}
+
+/**
+ * @brief Adds a prefix in CIDR notation.
+ *
+ * Host bits below the prefix length are ignored, so "10.1.2.3/8"
+ * blocks all of 10.0.0.0/8.
+ *
+ * @param cidr Prefix to block, e.g. "10.0.0.0/8".
+ * @return true if the prefix was valid and added.
+ */
+bool Blocklist::addCIDR(const std::string& cidr) {
+    size_t slash = cidr.find('/');
+    uint32_t ip;
+    if (!parseIP(cidr.substr(0, slash), ip)) {
+        return false;
+    }
+
+    int prefixLength = 32;
+    if (slash != std::string::npos) {
+        std::string bits = cidr.substr(slash + 1);
+        if (bits.empty() || bits.size() > 2
+            || !std::all_of(bits.begin(), bits.end(), ::isdigit)) {
+            return false;
+        }
+        prefixLength = std::stoi(bits);
+        if (prefixLength > 32) {
+            return false;
+        }
+    }
+
+    uint32_t hostMask = prefixLength == 0 ? ~uint32_t(0)
+                                          : (~uint32_t(0) >> prefixLength);
+    addRange(ip & ~hostMask, ip | hostMask);
+    return true;
+}
+
+/**
+ * @brief Replaces the contents with ranges read from a file.
+ *
+ * @param path Path of the blocklist file.
+ * @param error Receives a description of the first problem on failure.
+ * @return true if the file was read and every line was valid.
+ */
+bool Blocklist::loadFile(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open blocklist file " + path;
+        return false;
+    }
+
+    clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            continue;
+        }
+        size_t last = line.find_last_not_of(" \t\r");
+        std::string cidr = line.substr(first, last - first + 1);
+
+        if (!addCIDR(cidr)) {
+            error = path + ":" + std::to_string(lineNumber)
+                  + ": invalid CIDR prefix '" + cidr + "'";
+            return false;
+        }
+    }
+
+    compile();
+    return true;
+}
+
+/**
+ * @brief Sorts and merges the ranges into the lookup table.
+ *
+ * Overlapping and adjacent intervals are merged, so the table holds
+ * disjoint intervals sorted by start address.
+ */
+void Blocklist::compile() {
+    if (compiled) {
+        return;
+    }
+
+    std::vector<size_t> order(starts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return starts[a] < starts[b];
+    });
+
+    std::vector<uint32_t> mergedStarts;
+    std::vector<uint32_t> mergedEnds;
+    for (size_t i : order) {
+        if (!mergedEnds.empty()
+            && (mergedEnds.back() == ~uint32_t(0)
+                || starts[i] <= mergedEnds.back() + 1)) {
+            mergedEnds.back() = std::max(mergedEnds.back(), ends[i]);
+        } else {
+            mergedStarts.push_back(starts[i]);
+            mergedEnds.push_back(ends[i]);
+        }
+    }
+
+    starts.swap(mergedStarts);
+    ends.swap(mergedEnds);
+    compiled = true;
+}
+
+/**
+ * @brief Checks whether an address falls inside a blocked range.
+ *
+ * Finds the last interval starting at or before the address and checks
+ * its end.
+ *
+ * @param ip Packed IPv4 address.
+ * @return true if the address is blocked.
+ */
+bool Blocklist::contains(uint32_t ip) const {
+    auto it = std::upper_bound(starts.begin(), starts.end(), ip);
+    if (it == starts.begin()) {
+        return false;
+    }
+    return ip <= ends[(it - starts.begin()) - 1];
+}
+
+/**
+ * @brief Returns the number of disjoint intervals in the table.
+ *
+ * @return Interval count.
+ */
+size_t Blocklist::size() const {
+    return starts.size();
+}
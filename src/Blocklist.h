@@ -0,0 +1,92 @@
+#ifndef BLOCKLIST_H
+#define BLOCKLIST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Set of blocked IPv4 address ranges.
+ *
+ * Ranges are added as CIDR prefixes (or raw intervals) and compiled
+ * into a sorted table of disjoint intervals over packed IPv4 values.
+ * Lookups are a binary search over that table: O(log n) and
+ * allocation-free.
+ */
+class Blocklist {
+private:
+    /** Inclusive start of each interval, sorted ascending once compiled */
+    std::vector<uint32_t> starts;
+
+    /** Inclusive end of each interval, parallel to starts */
+    std::vector<uint32_t> ends;
+
+    /** True once pending ranges have been sorted and merged */
+    bool compiled;
+
+public:
+    /**
+     * @brief Constructs an empty blocklist.
+     */
+    Blocklist();
+
+    /**
+     * @brief Removes every range.
+     */
+    void clear();
+
+    /**
+     * @brief Adds an inclusive range of addresses.
+     *
+     * @param first First blocked address (packed IPv4)
+     * @param last Last blocked address (packed IPv4)
+     */
+    void addRange(uint32_t first, uint32_t last);
+
+    /**
+     * @brief Adds a prefix in CIDR notation, e.g. "10.0.0.0/8".
+     *
+     * A bare address without a prefix length blocks that single address.
+     *
+     * @param cidr Prefix to block
+     * @return true if the prefix was valid and added
+     */
+    bool addCIDR(const std::string& cidr);
+
+    /**
+     * @brief Replaces the contents with ranges read from a file.
+     *
+     * The file holds one CIDR prefix per line. Blank lines and text after
+     * a '#' are ignored. The table is compiled after loading.
+     *
+     * @param path Path of the blocklist file
+     * @param error Receives a description of the first problem on failure
+     * @return true if the file was read and every line was valid
+     */
+    bool loadFile(const std::string& path, std::string& error);
+
+    /**
+     * @brief Sorts and merges the ranges into the lookup table.
+     *
+     * Must be called after adding ranges and before contains().
+     */
+    void compile();
+
+    /**
+     * @brief Checks whether an address falls inside a blocked range.
+     *
+     * @param ip Packed IPv4 address
+     * @return true if the address is blocked
+     */
+    bool contains(uint32_t ip) const;
+
+    /**
+     * @brief Returns the number of disjoint intervals in the table.
+     *
+     * @return Interval count
+     */
+    size_t size() const;
+};
+
+#endif // BLOCKLIST_H
@@ -0,0 +1,63 @@
+/**
+ * @file CheckpointFile.cpp
+ * @brief Implementation of checkpoint file input and output.
+ *
+ * This file implements writing a checkpoint atomically and reading
+ * one back into memory.
+ */
+
+#include "CheckpointFile.h"
+#include <cstdio>
+
+/**
+ * @brief Writes the checkpoint, replacing any previous file atomically.
+ *
+ * @param path Destination path.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the checkpoint was written.
+ */
+bool CheckpointWriter::save(const std::string& path, std::string& error) const {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        error = "cannot create checkpoint " + temporary;
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        error = "cannot write checkpoint " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a whole checkpoint file into memory.
+ *
+ * @param path Checkpoint path.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the file was read.
+ */
+bool CheckpointReader::load(const std::string& path, std::string& error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open checkpoint " + path;
+        return false;
+    }
+    data.clear();
+    unsigned char block[1 << 16];
+    size_t n;
+    while ((n = std::fread(block, 1, sizeof(block), file)) > 0) {
+        data.insert(data.end(), block, block + n);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    position = 0;
+    failed = false;
+    if (!ok) {
+        error = "cannot read checkpoint " + path;
+    }
+    return ok;
+}
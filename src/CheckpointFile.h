@@ -0,0 +1,138 @@
+#ifndef CHECKPOINTFILE_H
+#define CHECKPOINTFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Builds a checkpoint in memory and writes it to disk in one step.
+ *
+ * Values are appended as raw bytes in native byte order, so a checkpoint
+ * is only meant to be restored by the same build on the same machine
+ * type. Arrays are prefixed with their element count.
+ */
+class CheckpointWriter {
+private:
+    std::vector<unsigned char> data;
+
+public:
+    /**
+     * @brief Appends one trivially copyable value.
+     *
+     * @param value Value to append
+     */
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * @brief Appends an element count followed by the elements.
+     *
+     * @param values First element
+     * @param n Number of elements
+     */
+    template <typename T>
+    void putArray(const T* values, size_t n) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+        put<uint64_t>(n);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+        data.insert(data.end(), bytes, bytes + n * sizeof(T));
+    }
+
+    /**
+     * @brief Writes the checkpoint, replacing any previous file atomically.
+     *
+     * The data goes to PATH.tmp first and is renamed over PATH, so a crash
+     * while writing leaves the previous checkpoint intact.
+     *
+     * @param path Destination path
+     * @param error Receives a description of the problem on failure
+     * @return true if the checkpoint was written
+     */
+    bool save(const std::string& path, std::string& error) const;
+};
+
+/**
+ * @brief Reads back a checkpoint written by CheckpointWriter.
+ *
+ * Every read is bounds-checked; after the first short read all further
+ * reads fail, so callers can check ok() once at the end.
+ */
+class CheckpointReader {
+private:
+    std::vector<unsigned char> data;
+    size_t position;
+    bool failed;
+
+public:
+    /**
+     * @brief Constructs a reader with no data.
+     */
+    CheckpointReader() : position(0), failed(false) {}
+
+    /**
+     * @brief Reads a whole checkpoint file into memory.
+     *
+     * @param path Checkpoint path
+     * @param error Receives a description of the problem on failure
+     * @return true if the file was read
+     */
+    bool load(const std::string& path, std::string& error);
+
+    /**
+     * @brief Reads one trivially copyable value.
+     *
+     * @param value Receives the value
+     * @return false if the data ran out
+     */
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+        if (failed || data.size() - position < sizeof(T)) {
+            failed = true;
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    /**
+     * @brief Reads an array written by putArray().
+     *
+     * @param values Receives the elements
+     * @return false if the data ran out
+     */
+    template <typename T>
+    bool getArray(std::vector<T>& values) {
+        uint64_t n = 0;
+        if (!get(n) || n > (data.size() - position) / sizeof(T)) {
+            failed = true;
+            return false;
+        }
+        values.resize(n);
+        if (n > 0) {
+            std::memcpy(values.data(), data.data() + position, n * sizeof(T));
+        }
+        position += n * sizeof(T);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether every read so far succeeded.
+     *
+     * @return true if no read ran past the end
+     */
+    bool ok() const {
+        return !failed;
+    }
+};
+
+#endif // CHECKPOINTFILE_H
@@ -0,0 +1,392 @@
+/**
+ * @file Cluster.cpp
+ * @brief Implementation of the multi-balancer cluster.
+ *
+ * This file implements the consistent-hash router, the epoch barrier
+ * that runs every node on its own thread, and the work stealing
+ * between node queues.
+ */
+
+#include "Cluster.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/** Quantiles reported in the final summary */
+static const double CLUSTER_QUANTILES[4] = {0.5, 0.9, 0.99, 0.999};
+
+/** Requests generated per batch while routing arrivals */
+static const size_t ROUTE_BATCH = 256;
+
+/**
+ * @brief Scrambles a 64-bit value (the SplitMix64 finalizer).
+ *
+ * @param x Value to scramble.
+ * @return Well-mixed hash of x.
+ */
+static uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Adds "-node<i>" before the extension of a path.
+ *
+ * Device paths such as /dev/null are shared by every node unchanged.
+ *
+ * @param path Configured path.
+ * @param node Node index.
+ * @return Path for that node.
+ */
+static std::string nodePath(const std::string& path, size_t node) {
+    if (path.compare(0, 5, "/dev/") == 0) {
+        return path;
+    }
+    std::string suffix = "-node" + std::to_string(node);
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + suffix;
+    }
+    return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+/**
+ * @brief Writes one set of percentiles as "p50/p90/p99/p99.9".
+ *
+ * @param out Destination stream.
+ * @param p Four percentile values.
+ */
+static void writePercentiles(std::ostream& out, const uint32_t p[4]) {
+    out << p[0] << "/" << p[1] << "/" << p[2] << "/" << p[3];
+}
+
+/**
+ * @brief Builds the nodes and the hash ring and starts the node threads.
+ *
+ * @param config Validated configuration.
+ */
+Cluster::Cluster(const SimConfig& config)
+    : config(config),
+      workload(config),
+      rng(Random::forStream(config.seed, 0)),
+      currentCycle(0),
+      console(&std::cout),
+      stolenIn(config.clusterNodes),
+      stolenOut(config.clusterNodes),
+      staged(config.clusterNodes),
+      generation(0),
+      pending(0),
+      epochEnd(0),
+      stopping(false)
+{
+    for (int i = 0; i < config.clusterNodes; i++) {
+        SimConfig nodeConfig = config;
+        nodeConfig.clusterNodes = 1;
+        // Consecutive seeds, as runs = N uses, would otherwise hand node i
+        // of one run the generator of node i + 1 or the router of the next
+        nodeConfig.seed = Random::forStream(config.seed, 1 + i).next();
+        nodeConfig.progress = false;
+        nodeConfig.logPath = nodePath(config.logPath, i);
+        if (!config.seriesPath.empty()) {
+            nodeConfig.seriesPath = nodePath(config.seriesPath, i);
+        }
+        if (!config.profileTracePath.empty()) {
+            nodeConfig.profileTracePath = nodePath(config.profileTracePath, i);
+        }
+        nodes.emplace_back(new LoadBalancer(nodeConfig));
+        nodes.back()->setConsole(nullptr);
+        nodes.back()->enableFeed();
+
+        for (int v = 0; v < config.clusterVnodes; v++) {
+            uint64_t point = mix64((static_cast<uint64_t>(i) << 32) | static_cast<uint32_t>(v));
+            ring.emplace_back(static_cast<uint32_t>(point >> 32), static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(ring.begin(), ring.end());
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        workers.emplace_back(&Cluster::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Stops and joins the node threads.
+ */
+Cluster::~Cluster() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startEpoch.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Loads the same blocklist into every node.
+ *
+ * @param path Path of a file with one CIDR prefix per line.
+ * @param error Receives a description of the problem on failure.
+ * @return true if every node loaded it.
+ */
+bool Cluster::loadBlocklist(const std::string& path, std::string& error) {
+    for (std::unique_ptr<LoadBalancer>& node : nodes) {
+        if (!node->loadBlocklist(path, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Redirects progress lines and the final summary.
+ *
+ * @param out Destination stream, or nullptr to print nothing.
+ */
+void Cluster::setConsole(std::ostream* out) {
+    console = out;
+}
+
+/**
+ * @brief Returns the node that owns a source address.
+ *
+ * The owner is the first ring point at or after the address's hash,
+ * wrapping around to the first point.
+ *
+ * @param ip Packed IPv4 source address.
+ * @return Node index.
+ */
+size_t Cluster::nodeFor(uint32_t ip) const {
+    uint32_t hash = static_cast<uint32_t>(mix64(ip) >> 32);
+    auto owner = std::lower_bound(ring.begin(), ring.end(), std::make_pair(hash, 0u));
+    return owner == ring.end() ? ring[0].second : owner->second;
+}
+
+/**
+ * @brief Main loop of the thread running one node.
+ *
+ * @param node Node index.
+ */
+void Cluster::workerLoop(size_t node) {
+    uint64_t seen = 0;
+    while (true) {
+        int target;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startEpoch.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            target = epochEnd;
+        }
+
+        nodes[node]->advanceTo(target);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            epochDone.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Runs every node up to a cycle and waits for all of them.
+ *
+ * @param cycle Cycle to stop at.
+ */
+void Cluster::runEpoch(int cycle) {
+    std::unique_lock<std::mutex> lock(mutex);
+    epochEnd = cycle;
+    pending = nodes.size();
+    generation++;
+    startEpoch.notify_all();
+    epochDone.wait(lock, [this] { return pending == 0; });
+}
+
+/**
+ * @brief Generates the arrivals of the coming epoch and feeds them
+ *        to their nodes.
+ *
+ * @param last Last cycle of the epoch.
+ */
+void Cluster::routeArrivals(int last) {
+    Request batch[ROUTE_BATCH];
+    for (int cycle = currentCycle + 1; cycle <= last; cycle++) {
+        size_t count = workload.arrivals(cycle, rng);
+        while (count > 0) {
+            size_t n = std::min(count, ROUTE_BATCH);
+            workload.generate(batch, n, cycle, rng);
+            for (size_t i = 0; i < n; i++) {
+                staged[nodeFor(batch[i].getIpIn())].push_back(batch[i]);
+            }
+            count -= n;
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i]->feedArrivals(staged[i].data(), staged[i].size());
+        staged[i].clear();
+    }
+}
+
+/**
+ * @brief Moves queued requests from long queues to short ones.
+ *
+ * Nodes are ranked by queue length; the longest is paired with the
+ * shortest, the second longest with the second shortest and so on.
+ * Each pair whose queues differ by more than the steal threshold is
+ * evened out. The gaps shrink down the ranking, so pairing stops at
+ * the first one within the threshold.
+ */
+void Cluster::rebalance() {
+    std::vector<size_t> length(nodes.size());
+    std::vector<size_t> order(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        length[i] = nodes[i]->queueLength();
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&length](size_t a, size_t b) {
+        return length[a] != length[b] ? length[a] > length[b] : a < b;
+    });
+
+    for (size_t k = 0; k < nodes.size() / 2; k++) {
+        size_t longer = order[k];
+        size_t shorter = order[nodes.size() - 1 - k];
+        size_t gap = length[longer] - length[shorter];
+        if (gap <= static_cast<size_t>(config.clusterSteal)) {
+            break;
+        }
+        moving.resize(gap / 2);
+        size_t taken = nodes[longer]->takeQueued(moving.data(), moving.size());
+        nodes[shorter]->acceptQueued(moving.data(), taken);
+        stolenOut[longer] += taken;
+        stolenIn[shorter] += taken;
+    }
+}
+
+/**
+ * @brief Prints one progress line for the whole cluster.
+ */
+void Cluster::printProgress() const {
+    if (!config.progress || !console) {
+        return;
+    }
+    int servers = 0;
+    size_t queue = 0;
+    long processed = 0;
+    long blocked = 0;
+    uint64_t stolen = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        RunSummary node = nodes[i]->getSummary();
+        servers += node.finalServers;
+        queue += node.endingQueue;
+        processed += node.processed;
+        blocked += node.blocked;
+        stolen += stolenIn[i];
+    }
+    *console << "[Cycle " << currentCycle << "] "
+             << "Nodes: " << nodes.size()
+             << ", Servers: " << servers
+             << ", Queue: " << queue
+             << ", Processed: " << processed
+             << ", Blocked: " << blocked
+             << ", Stolen: " << stolen
+             << "\n";
+}
+
+/**
+ * @brief Runs every node to the configured cycle count.
+ *
+ * Each epoch the router feeds the coming arrivals, the nodes run in
+ * parallel to the epoch's last cycle and the router then rebalances the
+ * queues. Afterwards every node writes its log footer, and the cluster
+ * totals and a per-node table are printed.
+ */
+void Cluster::Run() {
+    while (currentCycle < config.cycles) {
+        int last = std::min(currentCycle + config.clusterEpoch, config.cycles);
+        routeArrivals(last);
+        runEpoch(last);
+        bool logged = last / config.logInterval > currentCycle / config.logInterval;
+        currentCycle = last;
+        if (config.clusterSteal > 0) {
+            rebalance();
+        }
+        if (logged) {
+            printProgress();
+        }
+    }
+    for (std::unique_ptr<LoadBalancer>& node : nodes) {
+        node->finishRun();
+    }
+
+    if (!console) {
+        return;
+    }
+    RunSummary total = getSummary();
+    LatencyHistogram wait;
+    LatencyHistogram latency;
+    uint64_t stolen = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i]->mergeLatency(wait, latency);
+        stolen += stolenIn[i];
+    }
+    uint32_t waitP[4];
+    uint32_t latencyP[4];
+    wait.percentiles(CLUSTER_QUANTILES, 4, waitP);
+    latency.percentiles(CLUSTER_QUANTILES, 4, latencyP);
+
+    *console << "\nCluster simulation complete\n";
+    *console << "Nodes: " << nodes.size() << "\n";
+    *console << "Initial Servers: " << total.initialServers << "\n";
+    *console << "Final Servers: " << total.finalServers << "\n";
+    *console << "Requests Processed: " << total.processed << "\n";
+    *console << "Blocked Requests: " << total.blocked << "\n";
+    *console << "Stolen Requests: " << stolen << "\n";
+    *console << "Queue Wait p50/p90/p99/p99.9: ";
+    writePercentiles(*console, waitP);
+    *console << " cycles\nLatency p50/p90/p99/p99.9: ";
+    writePercentiles(*console, latencyP);
+    *console << " cycles\n\n";
+
+    *console << "Node  Servers  Processed  Blocked  Queue  StolenIn  StolenOut  Lat99\n";
+    for (size_t i = 0; i < nodes.size(); i++) {
+        RunSummary node = nodes[i]->getSummary();
+        *console << std::setw(4) << i
+                 << std::setw(9) << node.finalServers
+                 << std::setw(11) << node.processed
+                 << std::setw(9) << node.blocked
+                 << std::setw(7) << node.endingQueue
+                 << std::setw(10) << stolenIn[i]
+                 << std::setw(11) << stolenOut[i]
+                 << std::setw(7) << node.latencyP99 << "\n";
+    }
+}
+
+/**
+ * @brief Returns the cluster's combined counters.
+ *
+ * @return Sums over every node, with percentiles of the merged histograms.
+ */
+RunSummary Cluster::getSummary() const {
+    RunSummary summary = RunSummary();
+    LatencyHistogram wait;
+    LatencyHistogram latency;
+    for (const std::unique_ptr<LoadBalancer>& node : nodes) {
+        RunSummary part = node->getSummary();
+        summary.initialServers += part.initialServers;
+        summary.finalServers += part.finalServers;
+        summary.processed += part.processed;
+        summary.blocked += part.blocked;
+        summary.endingQueue += part.endingQueue;
+        node->mergeLatency(wait, latency);
+    }
+    summary.cycles = currentCycle;
+    summary.waitP99 = wait.percentile(0.99);
+    summary.latencyP50 = latency.percentile(0.5);
+    summary.latencyP99 = latency.percentile(0.99);
+    return summary;
+}
@@ -0,0 +1,163 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "LoadBalancer.h"
+#include "Random.h"
+#include "SimConfig.h"
+#include "Workload.h"
+
+/**
+ * @brief Several load balancers behind a consistent-hash router.
+ *
+ * Each node is a complete LoadBalancer with its own server pool, queue,
+ * autoscaler and log, running on its own thread. The router generates
+ * the cluster's arrivals and sends each request to the node that owns
+ * its source address on a hash ring with several virtual points per
+ * node, so a client always reaches the same node.
+ *
+ * Nodes run in lockstep epochs of a few cycles. Between epochs, with
+ * every node stopped, the router feeds the next epoch's arrivals and
+ * rebalances: a node whose queue is longer than another's by more than
+ * the steal threshold gives half the difference, oldest requests first,
+ * to the shorter one. Everything is decided on the router thread from
+ * seeded generators, so a cluster run is reproducible.
+ */
+class Cluster {
+private:
+    SimConfig config;
+    std::vector<std::unique_ptr<LoadBalancer>> nodes;
+
+    /** Hash ring: (point, node) pairs sorted by point */
+    std::vector<std::pair<uint32_t, uint32_t>> ring;
+
+    Workload workload;
+    Random rng;
+    int currentCycle;
+    std::ostream* console;
+
+    /** Requests each node took from others and gave to others */
+    std::vector<uint64_t> stolenIn;
+    std::vector<uint64_t> stolenOut;
+
+    /** Arrivals of the next epoch, per node, and room for moved requests */
+    std::vector<std::vector<Request>> staged;
+    std::vector<Request> moving;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startEpoch;
+    std::condition_variable epochDone;
+
+    /** Incremented each epoch to release the workers */
+    uint64_t generation;
+
+    /** Number of nodes still running the current epoch */
+    size_t pending;
+
+    /** Cycle every node runs up to in the current epoch */
+    int epochEnd;
+
+    bool stopping;
+
+    /**
+     * @brief Main loop of the thread running one node.
+     *
+     * @param node Node index
+     */
+    void workerLoop(size_t node);
+
+    /**
+     * @brief Runs every node up to a cycle and waits for all of them.
+     *
+     * @param cycle Cycle to stop at
+     */
+    void runEpoch(int cycle);
+
+    /**
+     * @brief Generates the arrivals of the coming epoch and feeds them
+     *        to their nodes.
+     *
+     * @param last Last cycle of the epoch
+     */
+    void routeArrivals(int last);
+
+    /**
+     * @brief Moves queued requests from long queues to short ones.
+     */
+    void rebalance();
+
+    /**
+     * @brief Prints one progress line for the whole cluster.
+     */
+    void printProgress() const;
+
+public:
+    /**
+     * @brief Builds the nodes and the hash ring.
+     *
+     * The router draws from stream 0 of the seed. Node i is seeded from
+     * the first draw of stream 1 + i, so no node shares a generator with
+     * the router, another node, or any node of a run with a nearby seed.
+     * Node i logs to the configured paths with "-node<i>" added before
+     * the extension.
+     *
+     * @param config Validated configuration with cluster > 1
+     */
+    explicit Cluster(const SimConfig& config);
+
+    /**
+     * @brief Stops the node threads.
+     */
+    ~Cluster();
+
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+
+    /**
+     * @brief Loads the same blocklist into every node.
+     *
+     * @param path Path of a file with one CIDR prefix per line
+     * @param error Receives a description of the problem on failure
+     * @return true if every node loaded it
+     */
+    bool loadBlocklist(const std::string& path, std::string& error);
+
+    /**
+     * @brief Redirects progress lines and the final summary.
+     *
+     * @param out Destination stream, or nullptr to print nothing
+     */
+    void setConsole(std::ostream* out);
+
+    /**
+     * @brief Returns the node that owns a source address.
+     *
+     * @param ip Packed IPv4 source address
+     * @return Node index
+     */
+    size_t nodeFor(uint32_t ip) const;
+
+    /**
+     * @brief Runs every node to the configured cycle count.
+     */
+    void Run();
+
+    /**
+     * @brief Returns the cluster's combined counters.
+     *
+     * @return Sums over every node, with percentiles of the merged histograms
+     */
+    RunSummary getSummary() const;
+};
+
+#endif // CLUSTER_H
@@ -0,0 +1,404 @@
+/**
+ * @file DispatchPolicy.cpp
+ * @brief Implementations of the request dispatch policies.
+ *
+ * This file implements round-robin, least-remaining-work, power of two
+ * choices and weighted least-outstanding dispatch, each backed by an
+ * index structure that keeps selection at O(log n) or better, except
+ * round-robin's bitmap scan past full servers.
+ */
+
+#include "DispatchPolicy.h"
+#include "IdleServerSet.h"
+#include "Random.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Segment tree returning the index with the smallest key.
+ *
+ * Ties go to the lowest index, so the choice is deterministic.
+ */
+class MinTree {
+private:
+    size_t leaves;
+    size_t used;
+    std::vector<double> keys;
+    std::vector<size_t> tree;
+
+    /**
+     * @brief Picks the better of two leaf indices.
+     */
+    size_t better(size_t a, size_t b) const {
+        return keys[b] < keys[a] ? b : a;
+    }
+
+    /**
+     * @brief Recomputes the path from a leaf to the root.
+     */
+    void fix(size_t leaf) {
+        for (size_t node = (leaf + leaves) / 2; node > 0; node /= 2) {
+            tree[node] = better(tree[2 * node], tree[2 * node + 1]);
+        }
+    }
+
+public:
+    static constexpr double INF = std::numeric_limits<double>::infinity();
+
+    MinTree() : leaves(0), used(0) {}
+
+    /**
+     * @brief Makes room for n leaves; leaves past n hold INF.
+     */
+    void resize(size_t n) {
+        if (n > leaves) {
+            size_t grown = leaves == 0 ? 64 : leaves;
+            while (grown < n) {
+                grown *= 2;
+            }
+            keys.resize(grown, INF);
+            leaves = grown;
+            tree.assign(2 * leaves, 0);
+            for (size_t i = 0; i < leaves; i++) {
+                tree[leaves + i] = i;
+            }
+            for (size_t node = leaves - 1; node > 0; node--) {
+                tree[node] = better(tree[2 * node], tree[2 * node + 1]);
+            }
+        }
+        for (size_t i = n; i < used; i++) {
+            set(i, INF);
+        }
+        used = n;
+    }
+
+    /**
+     * @brief Changes the key of one leaf.
+     */
+    void set(size_t i, double key) {
+        keys[i] = key;
+        fix(i);
+    }
+
+    /**
+     * @brief Returns the leaf with the smallest key, or NONE if all are INF.
+     */
+    size_t min() const {
+        size_t best = tree[1];
+        return keys[best] == INF ? DispatchPolicy::NONE : best;
+    }
+};
+
+/**
+ * @brief Unordered set of server indices that samples uniformly.
+ *
+ * Members are kept packed in an array, with each server's position in
+ * it, so adding, removing and drawing a uniformly random member are all
+ * O(1). Removal moves the last member into the hole, so the order
+ * depends on the history of updates; it is saved with the policy state
+ * to keep restored runs drawing the same members.
+ */
+class SampleSet {
+private:
+    static constexpr uint32_t ABSENT = UINT32_MAX;
+
+    std::vector<uint32_t> members;
+    std::vector<uint32_t> position;
+
+public:
+    /**
+     * @brief Covers n servers; new ones start outside the set.
+     */
+    void resize(size_t n) {
+        for (size_t i = n; i < position.size(); i++) {
+            set(i, false);
+        }
+        position.resize(n, ABSENT);
+    }
+
+    /**
+     * @brief Adds a server to the set or removes it.
+     */
+    void set(size_t i, bool member) {
+        if (member && position[i] == ABSENT) {
+            position[i] = static_cast<uint32_t>(members.size());
+            members.push_back(static_cast<uint32_t>(i));
+        } else if (!member && position[i] != ABSENT) {
+            uint32_t last = members.back();
+            members[position[i]] = last;
+            position[last] = position[i];
+            position[i] = ABSENT;
+            members.pop_back();
+        }
+    }
+
+    /**
+     * @brief Returns the number of servers in the set.
+     */
+    size_t count() const {
+        return members.size();
+    }
+
+    /**
+     * @brief Returns the member at a position of the packed array.
+     */
+    size_t at(size_t k) const {
+        return members[k];
+    }
+
+    /**
+     * @brief Appends the packed order of the members to a state vector.
+     */
+    void saveOrder(std::vector<uint64_t>& out) const {
+        out.insert(out.end(), members.begin(), members.end());
+    }
+
+    /**
+     * @brief Rearranges the members into an order written by saveOrder().
+     *
+     * @return false unless the order lists exactly the current members
+     */
+    bool restoreOrder(const uint64_t* order, size_t n) {
+        if (n != members.size()) {
+            return false;
+        }
+        for (size_t k = 0; k < n; k++) {
+            if (order[k] >= position.size() || position[order[k]] == ABSENT) {
+                return false;
+            }
+            position[order[k]] = static_cast<uint32_t>(k);
+        }
+        // A repeated server leaves an earlier entry pointing elsewhere
+        for (size_t k = 0; k < n; k++) {
+            if (position[order[k]] != k) {
+                return false;
+            }
+        }
+        for (size_t k = 0; k < n; k++) {
+            members[k] = static_cast<uint32_t>(order[k]);
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Cycles through servers that have room, in index order.
+ *
+ * The next server is found by scanning the bitmap from the cursor, so
+ * a long run of full servers costs one word per 64 of them, O(n / 64)
+ * at worst.
+ */
+class RoundRobinPolicy : public DispatchPolicy {
+private:
+    IdleServerSet open;
+    size_t cursor;
+
+public:
+    RoundRobinPolicy() : cursor(0) {}
+
+    void resize(size_t numServers) override {
+        while (open.size() < numServers) {
+            open.pushBack(false);
+        }
+        while (open.size() > numServers) {
+            open.popBack();
+        }
+    }
+
+    void update(size_t server, const ServerLoad& load) override {
+        if (load.outstanding < load.capacity) {
+            open.markIdle(server);
+        } else {
+            open.markBusy(server);
+        }
+    }
+
+    size_t select() override {
+        size_t server = open.findNext(cursor);
+        if (server == IdleServerSet::NONE) {
+            server = open.findFirst();
+        }
+        if (server != NONE) {
+            cursor = server + 1;
+        }
+        return server;
+    }
+
+    bool hasCapacity() const override {
+        return open.count() > 0;
+    }
+
+    void saveState(std::vector<uint64_t>& out) const override {
+        out.assign(1, cursor);
+    }
+
+    bool restoreState(const std::vector<uint64_t>& in) override {
+        if (in.size() != 1) {
+            return false;
+        }
+        cursor = in[0];
+        return true;
+    }
+
+    const char* name() const override {
+        return "round-robin";
+    }
+};
+
+/**
+ * @brief Sends each request to the server that drains its work soonest.
+ *
+ * The key is the cycle at which the server finishes everything it has
+ * been given, i.e. the current job's remaining time plus its local queue.
+ */
+class LeastWorkPolicy : public DispatchPolicy {
+private:
+    MinTree tree;
+
+public:
+    void resize(size_t numServers) override {
+        tree.resize(numServers);
+    }
+
+    void update(size_t server, const ServerLoad& load) override {
+        tree.set(server, load.outstanding < load.capacity ? load.drainCycle : MinTree::INF);
+    }
+
+    size_t select() override {
+        return tree.min();
+    }
+
+    bool hasCapacity() const override {
+        return tree.min() != NONE;
+    }
+
+    const char* name() const override {
+        return "least-work";
+    }
+};
+
+/**
+ * @brief Samples two servers with room and keeps the less loaded one.
+ *
+ * Each sample is drawn uniformly from the servers with room, so a
+ * server behind a run of full ones is no likelier to be chosen than any
+ * other.
+ */
+class PowerOfTwoPolicy : public DispatchPolicy {
+private:
+    SampleSet open;
+    std::vector<int> drain;
+    Random rng;
+
+    /**
+     * @brief Picks a uniformly random server with room.
+     */
+    size_t sample() {
+        return open.at(rng.uniform(static_cast<uint32_t>(open.count())));
+    }
+
+public:
+    explicit PowerOfTwoPolicy(uint64_t seed) : rng(Random::forStream(seed, 1)) {}
+
+    void resize(size_t numServers) override {
+        open.resize(numServers);
+        drain.resize(numServers, 0);
+    }
+
+    void update(size_t server, const ServerLoad& load) override {
+        drain[server] = load.drainCycle;
+        open.set(server, load.outstanding < load.capacity);
+    }
+
+    size_t select() override {
+        if (open.count() == 0) {
+            return NONE;
+        }
+        size_t first = sample();
+        size_t second = sample();
+        return drain[second] < drain[first] ? second : first;
+    }
+
+    bool hasCapacity() const override {
+        return open.count() > 0;
+    }
+
+    void saveState(std::vector<uint64_t>& out) const override {
+        out.resize(4);
+        rng.getState(out.data());
+        open.saveOrder(out);
+    }
+
+    bool restoreState(const std::vector<uint64_t>& in) override {
+        if (in.size() < 4 || !open.restoreOrder(in.data() + 4, in.size() - 4)) {
+            return false;
+        }
+        rng.setState(in.data());
+        return true;
+    }
+
+    const char* name() const override {
+        return "p2c";
+    }
+};
+
+/**
+ * @brief Weighted least outstanding requests.
+ *
+ * A server's key is (outstanding + 1) / weight: the load it would carry
+ * after accepting one more request, relative to its capacity.
+ */
+class WeightedPolicy : public DispatchPolicy {
+private:
+    MinTree tree;
+
+public:
+    void resize(size_t numServers) override {
+        tree.resize(numServers);
+    }
+
+    void update(size_t server, const ServerLoad& load) override {
+        tree.set(server, load.outstanding < load.capacity
+                 ? (load.outstanding + 1) / load.weight : MinTree::INF);
+    }
+
+    size_t select() override {
+        return tree.min();
+    }
+
+    bool hasCapacity() const override {
+        return tree.min() != NONE;
+    }
+
+    const char* name() const override {
+        return "weighted";
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Creates a policy by name.
+ *
+ * @param name Policy name.
+ * @param seed Seed for policies that make random choices.
+ * @return The policy, or null if the name is unknown.
+ */
+std::unique_ptr<DispatchPolicy> DispatchPolicy::create(const std::string& name, uint64_t seed) {
+    if (name == "round-robin") {
+        return std::unique_ptr<DispatchPolicy>(new RoundRobinPolicy());
+    }
+    if (name == "least-work") {
+        return std::unique_ptr<DispatchPolicy>(new LeastWorkPolicy());
+    }
+    if (name == "p2c") {
+        return std::unique_ptr<DispatchPolicy>(new PowerOfTwoPolicy(seed));
+    }
+    if (name == "weighted") {
+        return std::unique_ptr<DispatchPolicy>(new WeightedPolicy());
+    }
+    return nullptr;
+}
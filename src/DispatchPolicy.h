@@ -0,0 +1,115 @@
+#ifndef DISPATCHPOLICY_H
+#define DISPATCHPOLICY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Snapshot of one server's load, as seen by a dispatch policy.
+ */
+struct ServerLoad {
+    /** Requests running or waiting on the server */
+    size_t outstanding;
+
+    /** Maximum outstanding requests (running lanes + local queue length) */
+    size_t capacity;
+
+    /** Cycle at which the server will have finished all outstanding work */
+    int drainCycle;
+
+    /** Relative capacity of the server */
+    double weight;
+};
+
+/**
+ * @brief Strategy that picks which server receives the next request.
+ *
+ * The load balancer reports every change to a server's load through
+ * update(), so policies keep their own index structures and select()
+ * runs in O(1) or O(log n). Only servers with free capacity may be
+ * selected.
+ */
+class DispatchPolicy {
+public:
+    /** Returned by select() when every server is full */
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    virtual ~DispatchPolicy() {}
+
+    /**
+     * @brief Grows or shrinks the pool the policy tracks.
+     *
+     * New servers must be described with update() before the next select().
+     *
+     * @param numServers New pool size
+     */
+    virtual void resize(size_t numServers) = 0;
+
+    /**
+     * @brief Records a server's new load.
+     *
+     * @param server Server index
+     * @param load Current load of that server
+     */
+    virtual void update(size_t server, const ServerLoad& load) = 0;
+
+    /**
+     * @brief Picks a server with free capacity.
+     *
+     * @return Server index, or NONE if every server is full
+     */
+    virtual size_t select() = 0;
+
+    /**
+     * @brief Checks whether any server can accept a request.
+     *
+     * @return true if select() would succeed
+     */
+    virtual bool hasCapacity() const = 0;
+
+    /**
+     * @brief Returns internal state that update() calls do not rebuild.
+     *
+     * Used for checkpoints: after a restore every server is reported with
+     * update() again, then this state is put back with restoreState().
+     *
+     * @param out Receives the state words; empty for stateless policies
+     */
+    virtual void saveState(std::vector<uint64_t>& out) const {
+        out.clear();
+    }
+
+    /**
+     * @brief Restores state returned by saveState().
+     *
+     * @param in State words
+     * @return false if the words do not belong to this policy
+     */
+    virtual bool restoreState(const std::vector<uint64_t>& in) {
+        return in.empty();
+    }
+
+    /**
+     * @brief Returns the policy's configuration name.
+     *
+     * @return Name such as "least-work"
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Creates a policy by name.
+     *
+     * Known names are round-robin, least-work, p2c (power of two
+     * choices) and weighted (weighted least outstanding requests).
+     *
+     * @param name Policy name
+     * @param seed Seed for policies that make random choices
+     * @return The policy, or null if the name is unknown
+     */
+    static std::unique_ptr<DispatchPolicy> create(const std::string& name, uint64_t seed);
+};
+
+#endif // DISPATCHPOLICY_H
@@ -0,0 +1,128 @@
+/**
+ * @file FlowTable.cpp
+ * @brief Implementation of the sticky-routing flow table.
+ *
+ * This file implements inserting and evicting flows, the summary
+ * counters and checkpointing of the table.
+ */
+
+#include "FlowTable.h"
+
+/**
+ * @brief Constructs an empty table.
+ *
+ * @param maxFlows Flows to hold; rounded up to a power of two of at least PROBE_LIMIT.
+ * @param ttl Cycles an unused flow stays pinned.
+ */
+FlowTable::FlowTable(size_t maxFlows, int ttl)
+    : shift(64),
+      ttl(ttl),
+      evictionCount(0)
+{
+    size_t size = 1;
+    while (size < maxFlows || size < PROBE_LIMIT) {
+        size <<= 1;
+        shift--;
+    }
+    slots.assign(size, Flow());
+    mask = size - 1;
+}
+
+/**
+ * @brief Pins a client that has no live flow.
+ *
+ * Takes the first expired or empty slot of the probe window, or else
+ * evicts the live flow that would expire soonest.
+ *
+ * @param ip Packed IPv4 source address.
+ * @param server Server index.
+ * @param generation Slot generation of that server.
+ * @param now Current cycle.
+ */
+void FlowTable::insert(uint32_t ip, uint32_t server, uint32_t generation, int now) {
+    size_t slot = home(ip);
+    size_t victim = slot;
+    for (size_t i = 0; i < PROBE_LIMIT; i++, slot = (slot + 1) & mask) {
+        if (slots[slot].expires <= now) {
+            victim = slot;
+            break;
+        }
+        if (slots[slot].expires < slots[victim].expires) {
+            victim = slot;
+        }
+    }
+    Flow& flow = slots[victim];
+    if (flow.expires > now) {
+        evictionCount++;
+    }
+    flow.ip = ip;
+    flow.server = server;
+    flow.generation = generation;
+    flow.expires = expiry(now);
+}
+
+/**
+ * @brief Returns the number of slots.
+ *
+ * @return Largest number of flows the table can hold.
+ */
+size_t FlowTable::capacity() const {
+    return slots.size();
+}
+
+/**
+ * @brief Counts the flows that have not expired.
+ *
+ * @param now Current cycle.
+ * @return Live flows.
+ */
+size_t FlowTable::liveCount(int now) const {
+    size_t count = 0;
+    for (const Flow& flow : slots) {
+        count += flow.expires > now;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns how many live flows were evicted to make room.
+ *
+ * @return Eviction count.
+ */
+uint64_t FlowTable::evictions() const {
+    return evictionCount;
+}
+
+/**
+ * @brief Writes every slot to a checkpoint.
+ *
+ * @param out Checkpoint being written.
+ */
+void FlowTable::save(CheckpointWriter& out) const {
+    out.putArray(slots.data(), slots.size());
+    out.put(evictionCount);
+}
+
+/**
+ * @brief Restores slots written by save().
+ *
+ * @param in Checkpoint being read.
+ * @param numServers Number of server slots; every flow must name one of them.
+ * @return false if the data is truncated, was written for another size
+ *         or names a server that does not exist.
+ */
+bool FlowTable::load(CheckpointReader& in, size_t numServers) {
+    std::vector<Flow> saved;
+    in.getArray(saved);
+    in.get(evictionCount);
+    if (!in.ok() || saved.size() != slots.size()) {
+        return false;
+    }
+    for (const Flow& flow : saved) {
+        if (flow.server >= numServers) {
+            return false;
+        }
+    }
+    slots.swap(saved);
+    return true;
+}
@@ -0,0 +1,159 @@
+#ifndef FLOWTABLE_H
+#define FLOWTABLE_H
+
+#include <cstddef>
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "CheckpointFile.h"
+
+/**
+ * @brief Fixed-size table pinning client addresses to servers.
+ *
+ * Open addressing with linear probing over a power-of-two array of
+ * 16-byte flows. A flow may sit at most PROBE_LIMIT slots past its home
+ * slot, so a lookup reads at most one short run of adjacent slots and
+ * never chases a chain, whatever the load.
+ *
+ * A flow lives until ttl cycles after it was last used. Expired flows
+ * are not removed; their slots are simply free for the next insert.
+ * When every slot in a new flow's probe window is live, the flow that
+ * would expire soonest is evicted, so the table never grows past the
+ * size it was built with.
+ */
+class FlowTable {
+public:
+    /** Slots a flow may be placed past its home slot, including it */
+    static const size_t PROBE_LIMIT = 8;
+
+    /**
+     * @brief One pinned client.
+     */
+    struct Flow {
+        /** Packed IPv4 source address */
+        uint32_t ip;
+
+        /** Server index the client is pinned to */
+        uint32_t server;
+
+        /** Slot generation of that server when the client was pinned */
+        uint32_t generation;
+
+        /** Cycle from which the flow no longer counts; 0 for an empty slot */
+        int expires;
+    };
+
+private:
+    std::vector<Flow> slots;
+    size_t mask;
+    int shift;
+    int ttl;
+    uint64_t evictionCount;
+
+    /**
+     * @brief Returns a flow's home slot.
+     *
+     * @param ip Packed IPv4 source address
+     * @return Slot index
+     */
+    size_t home(uint32_t ip) const {
+        return static_cast<size_t>((ip * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    /**
+     * @brief Returns the expiry cycle of a flow used now.
+     *
+     * Saturates at INT_MAX, so a ttl too large to add pins for the
+     * whole run rather than overflowing.
+     *
+     * @param now Current cycle
+     * @return Cycle from which the flow no longer counts
+     */
+    int expiry(int now) const {
+        return ttl > INT_MAX - now ? INT_MAX : now + ttl;
+    }
+
+public:
+    /**
+     * @brief Constructs an empty table.
+     *
+     * @param maxFlows Flows to hold; rounded up to a power of two of at least PROBE_LIMIT
+     * @param ttl Cycles an unused flow stays pinned
+     */
+    FlowTable(size_t maxFlows, int ttl);
+
+    /**
+     * @brief Looks up the live flow of a client.
+     *
+     * A hit renews the flow. The server and generation of the returned
+     * flow may be rewritten to rehome it.
+     *
+     * @param ip Packed IPv4 source address
+     * @param now Current cycle
+     * @return The flow, or nullptr if the client has none
+     */
+    Flow* find(uint32_t ip, int now) {
+        size_t slot = home(ip);
+        for (size_t i = 0; i < PROBE_LIMIT; i++, slot = (slot + 1) & mask) {
+            Flow& flow = slots[slot];
+            if (flow.ip == ip && flow.expires > now) {
+                flow.expires = expiry(now);
+                return &flow;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Pins a client that has no live flow.
+     *
+     * @param ip Packed IPv4 source address
+     * @param server Server index
+     * @param generation Slot generation of that server
+     * @param now Current cycle
+     */
+    void insert(uint32_t ip, uint32_t server, uint32_t generation, int now);
+
+    /**
+     * @brief Returns the number of slots.
+     *
+     * @return Largest number of flows the table can hold
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Counts the flows that have not expired.
+     *
+     * Walks the whole table; meant for summaries, not the dispatch path.
+     *
+     * @param now Current cycle
+     * @return Live flows
+     */
+    size_t liveCount(int now) const;
+
+    /**
+     * @brief Returns how many live flows were evicted to make room.
+     *
+     * @return Eviction count
+     */
+    uint64_t evictions() const;
+
+    /**
+     * @brief Writes every slot to a checkpoint.
+     *
+     * @param out Checkpoint being written
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Restores slots written by save().
+     *
+     * @param in Checkpoint being read
+     * @param numServers Number of server slots; every flow must name one of them
+     * @return false if the data is truncated, was written for another size
+     *         or names a server that does not exist
+     */
+    bool load(CheckpointReader& in, size_t numServers);
+};
+
+#endif // FLOWTABLE_H
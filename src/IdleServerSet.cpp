@@ -0,0 +1,154 @@
+/**
+ * @file IdleServerSet.cpp
+ * @brief Implementation of the IdleServerSet bitmap.
+ *
+ * This file implements the idle-server bitmap that lets the load
+ * balancer find free servers without scanning the whole pool.
+ */
+
+#include "IdleServerSet.h"
+
+/**
+ * @brief Constructs an empty set covering no servers.
+ */
+IdleServerSet::IdleServerSet()
+    : numServers(0),
+      idleCount(0)
+{
+}
+
+/**
+ * @brief Adds a server slot at the end of the pool.
+ *
+ * @param idle True to mark the new slot idle, false to mark it busy.
+ */
+void IdleServerSet::pushBack(bool idle) {
+    if (numServers % 64 == 0) {
+        words.push_back(0);
+    }
+    numServers++;
+    if (idle) {
+        markIdle(numServers - 1);
+    }
+}
+
+/**
+ * @brief Removes the last server slot from the pool.
+ *
+ * The slot is cleared first so the idle count stays accurate.
+ */
+void IdleServerSet::popBack() {
+    if (numServers == 0) {
+        return;
+    }
+    markBusy(numServers - 1);
+    numServers--;
+    if (numServers % 64 == 0) {
+        words.pop_back();
+    }
+}
+
+/**
+ * @brief Marks a server as idle.
+ *
+ * @param index Server index in the pool.
+ */
+void IdleServerSet::markIdle(size_t index) {
+    uint64_t bit = uint64_t(1) << (index % 64);
+    uint64_t& word = words[index / 64];
+    if (!(word & bit)) {
+        word |= bit;
+        idleCount++;
+    }
+}
+
+/**
+ * @brief Marks a server as busy.
+ *
+ * @param index Server index in the pool.
+ */
+void IdleServerSet::markBusy(size_t index) {
+    uint64_t bit = uint64_t(1) << (index % 64);
+    uint64_t& word = words[index / 64];
+    if (word & bit) {
+        word &= ~bit;
+        idleCount--;
+    }
+}
+
+/**
+ * @brief Checks whether a server is idle.
+ *
+ * @param index Server index in the pool.
+ * @return true if the server is marked idle.
+ */
+bool IdleServerSet::isIdle(size_t index) const {
+    return (words[index / 64] >> (index % 64)) & 1;
+}
+
+/**
+ * @brief Finds the lowest idle server index at or after a position.
+ *
+ * Skips whole 64-server words at a time and uses a count-trailing-zeros
+ * instruction to locate the bit inside a word.
+ *
+ * @param from First index to consider.
+ * @return Idle server index, or NONE if there is none.
+ */
+size_t IdleServerSet::findNext(size_t from) const {
+    if (idleCount == 0 || from >= numServers) {
+        return NONE;
+    }
+
+    size_t w = from / 64;
+    uint64_t word = words[w] & (~uint64_t(0) << (from % 64));
+    while (word == 0) {
+        if (++w == words.size()) {
+            return NONE;
+        }
+        word = words[w];
+    }
+    return w * 64 + __builtin_ctzll(word);
+}
+
+/**
+ * @brief Finds the lowest idle server index.
+ *
+ * @return Idle server index, or NONE if there is none.
+ */
+size_t IdleServerSet::findFirst() const {
+    return findNext(0);
+}
+
+/**
+ * @brief Finds the highest idle server index.
+ *
+ * @return Idle server index, or NONE if there is none.
+ */
+size_t IdleServerSet::findLast() const {
+    if (idleCount == 0) {
+        return NONE;
+    }
+    size_t w = words.size();
+    while (words[--w] == 0) {
+    }
+    return w * 64 + 63 - __builtin_clzll(words[w]);
+}
+
+/**
+ * @brief Returns the number of idle servers.
+ *
+ * @return Count of servers marked idle.
+ */
+size_t IdleServerSet::count() const {
+    return idleCount;
+}
+
+/**
+ * @brief Returns the number of server slots covered.
+ *
+ * @return Pool size.
+ */
+size_t IdleServerSet::size() const {
+    return numServers;
+}
@@ -0,0 +1,101 @@
+#ifndef IDLESERVERSET_H
+#define IDLESERVERSET_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Tracks which web servers in the pool are idle.
+ *
+ * Idle server indices are stored as a bitmap so that marking a server
+ * busy or idle is O(1), and the lowest idle index (the first free server
+ * in pool order) is found one 64-bit word at a time.
+ */
+class IdleServerSet {
+private:
+    std::vector<uint64_t> words;
+    size_t numServers;
+    size_t idleCount;
+
+public:
+    /** Returned by findFirst()/findNext() when no idle server remains */
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    /**
+     * @brief Constructs an empty set covering no servers.
+     */
+    IdleServerSet();
+
+    /**
+     * @brief Adds a server slot at the end of the pool.
+     *
+     * @param idle True to mark the new slot idle, false to mark it busy
+     */
+    void pushBack(bool idle = true);
+
+    /**
+     * @brief Removes the last server slot from the pool.
+     */
+    void popBack();
+
+    /**
+     * @brief Marks a server as idle.
+     *
+     * @param index Server index in the pool
+     */
+    void markIdle(size_t index);
+
+    /**
+     * @brief Marks a server as busy.
+     *
+     * @param index Server index in the pool
+     */
+    void markBusy(size_t index);
+
+    /**
+     * @brief Checks whether a server is idle.
+     *
+     * @param index Server index in the pool
+     * @return true if the server is marked idle
+     */
+    bool isIdle(size_t index) const;
+
+    /**
+     * @brief Finds the lowest idle server index at or after a position.
+     *
+     * @param from First index to consider
+     * @return Idle server index, or NONE if there is none
+     */
+    size_t findNext(size_t from) const;
+
+    /**
+     * @brief Finds the lowest idle server index.
+     *
+     * @return Idle server index, or NONE if there is none
+     */
+    size_t findFirst() const;
+
+    /**
+     * @brief Finds the highest idle server index.
+     *
+     * @return Idle server index, or NONE if there is none
+     */
+    size_t findLast() const;
+
+    /**
+     * @brief Returns the number of idle servers.
+     *
+     * @return Count of servers marked idle
+     */
+    size_t count() const;
+
+    /**
+     * @brief Returns the number of server slots covered.
+     *
+     * @return Pool size
+     */
+    size_t size() const;
+};
+
+#endif // IDLESERVERSET_H
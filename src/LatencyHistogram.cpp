@@ -0,0 +1,190 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Implementation of the log-linear latency histogram.
+ *
+ * This file implements bucket mapping, merging and percentile
+ * queries for LatencyHistogram.
+ */
+
+#include "LatencyHistogram.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Constructs an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+/**
+ * @brief Maps a value to its bucket.
+ *
+ * Small values index the exact range directly. Larger values are
+ * identified by the position of their top bit and the next
+ * PRECISION_BITS - 1 bits below it.
+ *
+ * @param value Latency in clock cycles.
+ * @return Bucket index.
+ */
+size_t LatencyHistogram::bucketOf(uint32_t value) {
+    const uint32_t exact = uint32_t(1) << PRECISION_BITS;
+    if (value < exact) {
+        return value;
+    }
+    int top = 31 - __builtin_clz(value);
+    int shift = top - PRECISION_BITS + 1;
+    size_t half = size_t(1) << (PRECISION_BITS - 1);
+    return exact + (top - PRECISION_BITS) * half + ((value >> shift) - half);
+}
+
+/**
+ * @brief Returns the largest value that maps to a bucket.
+ *
+ * @param bucket Bucket index.
+ * @return Highest equivalent value.
+ */
+uint32_t LatencyHistogram::highestInBucket(size_t bucket) {
+    const size_t exact = size_t(1) << PRECISION_BITS;
+    if (bucket < exact) {
+        return static_cast<uint32_t>(bucket);
+    }
+    size_t half = exact / 2;
+    size_t offset = bucket - exact;
+    int shift = static_cast<int>(offset / half) + 1;
+    uint64_t mantissa = half + offset % half;
+    return static_cast<uint32_t>(((mantissa + 1) << shift) - 1);
+}
+
+/**
+ * @brief Adds every value recorded in another histogram.
+ *
+ * @param other Histogram to add.
+ */
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.total == 0) {
+        return;
+    }
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    if (other.maxValue > maxValue) {
+        maxValue = other.maxValue;
+    }
+}
+
+/**
+ * @brief Removes every recorded value.
+ */
+void LatencyHistogram::reset() {
+    std::memset(counts, 0, sizeof(counts));
+    total = 0;
+    maxValue = 0;
+}
+
+/**
+ * @brief Returns the number of recorded values.
+ *
+ * @return Value count.
+ */
+uint64_t LatencyHistogram::count() const {
+    return total;
+}
+
+/**
+ * @brief Returns the largest recorded value.
+ *
+ * @return Exact maximum, or 0 if the histogram is empty.
+ */
+uint32_t LatencyHistogram::max() const {
+    return maxValue;
+}
+
+/**
+ * @brief Computes several percentiles in one pass over the buckets.
+ *
+ * The value at quantile q is the one with rank ceil(q * count), counting
+ * from 1, so p100 is the maximum.
+ *
+ * @param quantiles Quantiles in [0, 1], in ascending order.
+ * @param n Number of quantiles.
+ * @param out Receives one value per quantile; all 0 if empty.
+ */
+void LatencyHistogram::percentiles(const double* quantiles, size_t n, uint32_t* out) const {
+    size_t next = 0;
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < NUM_BUCKETS && next < n && total > 0; bucket++) {
+        seen += counts[bucket];
+        while (next < n) {
+            uint64_t rank = static_cast<uint64_t>(std::ceil(quantiles[next] * total));
+            if (rank < 1) {
+                rank = 1;
+            }
+            if (seen < rank) {
+                break;
+            }
+            uint32_t value = highestInBucket(bucket);
+            out[next++] = value < maxValue ? value : maxValue;
+        }
+    }
+    for (; next < n; next++) {
+        out[next] = total > 0 ? maxValue : 0;
+    }
+}
+
+/**
+ * @brief Writes the non-empty buckets to a checkpoint.
+ *
+ * Buckets are stored as (index, count) pairs, so a histogram costs a
+ * few hundred bytes rather than its full bucket array.
+ *
+ * @param out Checkpoint being built.
+ */
+void LatencyHistogram::save(CheckpointWriter& out) const {
+    std::vector<uint64_t> pairs;
+    for (size_t i = 0; i < NUM_BUCKETS; i++) {
+        if (counts[i] != 0) {
+            pairs.push_back(i);
+            pairs.push_back(counts[i]);
+        }
+    }
+    out.put(maxValue);
+    out.putArray(pairs.data(), pairs.size());
+}
+
+/**
+ * @brief Replaces the contents with a histogram read from a checkpoint.
+ *
+ * @param in Checkpoint being read.
+ * @return false if the checkpoint data is malformed.
+ */
+bool LatencyHistogram::load(CheckpointReader& in) {
+    reset();
+    std::vector<uint64_t> pairs;
+    if (!in.get(maxValue) || !in.getArray(pairs) || pairs.size() % 2 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < pairs.size(); i += 2) {
+        if (pairs[i] >= NUM_BUCKETS) {
+            return false;
+        }
+        counts[pairs[i]] = pairs[i + 1];
+        total += pairs[i + 1];
+    }
+    return true;
+}
+
+/**
+ * @brief Computes one percentile.
+ *
+ * @param quantile Quantile in [0, 1], e.g. 0.99.
+ * @return Latency at that quantile, or 0 if empty.
+ */
+uint32_t LatencyHistogram::percentile(double quantile) const {
+    uint32_t value;
+    percentiles(&quantile, 1, &value);
+    return value;
+}
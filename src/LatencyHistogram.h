@@ -0,0 +1,122 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include "CheckpointFile.h"
+
+/**
+ * @brief Fixed-memory log-linear histogram of latencies in clock cycles.
+ *
+ * Values below 2^PRECISION_BITS get a bucket each; above that every
+ * power-of-two range is split into 2^(PRECISION_BITS-1) equal buckets,
+ * as in HdrHistogram. Recorded values are therefore kept to within
+ * 1/64 of their true value, recording is O(1), and the whole histogram is
+ * one flat array of counters no matter how many values it holds.
+ */
+class LatencyHistogram {
+private:
+    /** Bits of exact resolution; values below 2^PRECISION_BITS are exact */
+    static constexpr int PRECISION_BITS = 7;
+
+    /** Buckets covering every 32-bit value */
+    static constexpr size_t NUM_BUCKETS =
+        (size_t(1) << PRECISION_BITS) + (32 - PRECISION_BITS) * (size_t(1) << (PRECISION_BITS - 1));
+
+    uint64_t counts[NUM_BUCKETS];
+    uint64_t total;
+    uint32_t maxValue;
+
+    /**
+     * @brief Maps a value to its bucket.
+     */
+    static size_t bucketOf(uint32_t value);
+
+    /**
+     * @brief Returns the largest value that maps to a bucket.
+     */
+    static uint32_t highestInBucket(size_t bucket);
+
+public:
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Records one latency.
+     *
+     * @param value Latency in clock cycles; negative values count as 0
+     */
+    void record(int value) {
+        uint32_t v = value < 0 ? 0 : static_cast<uint32_t>(value);
+        counts[bucketOf(v)]++;
+        total++;
+        if (v > maxValue) {
+            maxValue = v;
+        }
+    }
+
+    /**
+     * @brief Adds every value recorded in another histogram.
+     *
+     * @param other Histogram to add
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Removes every recorded value.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the number of recorded values.
+     *
+     * @return Value count
+     */
+    uint64_t count() const;
+
+    /**
+     * @brief Returns the largest recorded value.
+     *
+     * @return Exact maximum, or 0 if the histogram is empty
+     */
+    uint32_t max() const;
+
+    /**
+     * @brief Computes several percentiles in one pass.
+     *
+     * Each result is the highest value equivalent to the one at that
+     * rank, capped at the recorded maximum.
+     *
+     * @param quantiles Quantiles in [0, 1], in ascending order
+     * @param n Number of quantiles
+     * @param out Receives one value per quantile; all 0 if empty
+     */
+    void percentiles(const double* quantiles, size_t n, uint32_t* out) const;
+
+    /**
+     * @brief Writes the non-empty buckets to a checkpoint.
+     *
+     * @param out Checkpoint being built
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Replaces the contents with a histogram read from a checkpoint.
+     *
+     * @param in Checkpoint being read
+     * @return false if the checkpoint data is malformed
+     */
+    bool load(CheckpointReader& in);
+
+    /**
+     * @brief Computes one percentile.
+     *
+     * @param quantile Quantile in [0, 1], e.g. 0.99
+     * @return Latency at that quantile, or 0 if empty
+     */
+    uint32_t percentile(double quantile) const;
+};
+
+#endif // LATENCYHISTOGRAM_H
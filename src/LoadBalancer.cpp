@@ -8,140 +8,1413 @@
  */
 
 #include "LoadBalancer.h"
-#include <cstdlib>
-#include <ctime>
 #include <iostream>
-#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+
+/** First bytes of every checkpoint file */
+static const char CHECKPOINT_MAGIC[8] = {'L', 'B', 'C', 'K', 'P', 'T', '0', '1'};
+
+/** Checkpoint layout version, bumped whenever the saved fields change */
+static const uint32_t CHECKPOINT_VERSION = 6;
+
+/** Slot states stored in a checkpoint */
+enum SlotState : uint8_t { SLOT_ACTIVE = 0, SLOT_DRAINING = 1, SLOT_FREE = 2 };
+
+/** Trace position saved when no trace is replayed */
+static const uint64_t NO_TRACE = ~0ull;
+
+/** Percentiles reported for latency histograms */
+static const double LATENCY_QUANTILES[4] = {0.5, 0.9, 0.99, 0.999};
+
+/** Number of columns in the time series */
+static const size_t SERIES_COLUMN_COUNT = 13;
+
+/** Time series columns: the state line, then interval percentiles for all jobs */
+static const char* const SERIES_COLUMNS[SERIES_COLUMN_COUNT] = {
+    "cycle", "servers", "queue", "processed", "blocked",
+    "wait_p50", "wait_p90", "wait_p99", "wait_p999",
+    "latency_p50", "latency_p90", "latency_p99", "latency_p999"
+};
+
+/**
+ * @brief Computes the reported percentiles for both job types and their union.
+ *
+ * @param byType Histograms indexed by isStreamingJob().
+ * @param out Receives p50/p90/p99/p99.9 for all, streaming and processing jobs.
+ */
+static void latencyPercentiles(const LatencyHistogram byType[2], uint32_t out[3][4]) {
+    LatencyHistogram all = byType[0];
+    all.merge(byType[1]);
+    all.percentiles(LATENCY_QUANTILES, 4, out[0]);
+    byType[1].percentiles(LATENCY_QUANTILES, 4, out[1]);
+    byType[0].percentiles(LATENCY_QUANTILES, 4, out[2]);
+}
+
+/**
+ * @brief Writes one set of percentiles as "p50/p90/p99/p99.9".
+ *
+ * @param out Destination stream.
+ * @param p Four percentile values.
+ */
+static void writePercentiles(std::ostream& out, const uint32_t p[4]) {
+    out << p[0] << "/" << p[1] << "/" << p[2] << "/" << p[3];
+}
+
+/**
+ * @brief Builds the configuration used by the legacy constructor.
+ *
+ * @param numServers Initial number of web servers.
+ * @param runTime Number of clock cycles to run the simulation.
+ * @param seed Seed for the random generator.
+ * @param eventDriven True to use the discrete-event scheduler.
+ * @return Default configuration with those four settings applied.
+ */
+static SimConfig makeConfig(int numServers, int runTime, uint64_t seed, bool eventDriven) {
+    SimConfig config;
+    config.servers = numServers;
+    config.cycles = runTime;
+    config.seed = seed;
+    config.eventDriven = eventDriven;
+    return config;
+}
+
+/**
+ * @brief Constructs a LoadBalancer with the specified number of servers and runtime.
+ *
+ * Uses the default thresholds, job ranges and log file.
+ *
+ * @param numServers Initial number of web servers.
+ * @param runTime Number of clock cycles to run the simulation.
+ * @param seed Seed for the random generator; equal seeds give equal runs.
+ * @param eventDriven True to use the discrete-event scheduler.
+ */
+LoadBalancer::LoadBalancer(int numServers, int runTime, uint64_t seed, bool eventDriven)
+    : LoadBalancer(makeConfig(numServers, runTime, seed, eventDriven))
+{
+}
+
+/**
+ * @brief Constructs a LoadBalancer from a full configuration.
+ *
+ * Seeds the random generator, creates the initial web servers, populates the request queue,
+ * and opens a log file for recording simulation events.
+ *
+ * @param config Simulation parameters.
+ */
+LoadBalancer::LoadBalancer(const SimConfig& config)
+    : webServers(config.dispatch == "first-idle" ? 0 : static_cast<size_t>(config.serverQueue)),
+      currentClockCycle(0),
+      runningTime(config.cycles),
+      initialNumServers(0),
+      config(config),
+      workload(config),
+      totalRequestsProcessed(0),
+      blockedRequests(0),
+      stickyHits(0),
+      stickyFallbacks(0),
+      stickyRehomes(0),
+      stickyPins(0),
+      eventDriven(config.eventDriven),
+      nextArrivalCycle(0),
+      nextArrivalCount(0),
+      rejectedSubmissions(0),
+      rng(config.seed),
+      console(&std::cout)
+{
+    blocklist.addRange(192u << 24, (201u << 24) - 1);
+    blocklist.compile();
+    createWebServers();
+    if (config.tracePath.empty()) {
+        populateReqQueue(initialNumServers);
+    }
+    setNumShards(config.shards);
+    logger.setLevel(config.logLevel);
+    logger.setSampling(config.logSample);
+
+    if (!logger.open(config.logPath)) {
+        std::cerr << "Warning: cannot open log file " << config.logPath << "\n";
+    }
+    if (!config.profileTracePath.empty()) {
+        if (PHASE_TIMING) {
+            profiler.enableTrace();
+        } else {
+            std::cerr << "Warning: profile-trace needs a build with phase timing (make timing)\n";
+        }
+    }
+    startMetrics();
+    openSeries();
+
+    std::ostringstream header;
+    header << "===== LOAD BALANCER SIMULATION START =====\n";
+    header << "Initial Servers: " << initialNumServers << "\n";
+    header << "Planned Clock Cycles: " << config.cycles << "\n";
+    header << "Seed: " << config.seed << "\n";
+    if (!config.serverClasses.empty()) {
+        static const char* const jobNames[] = {"any", "streaming", "processing"};
+        header << "Server Classes:\n";
+        for (const ServerGroup& group : groups) {
+            header << "  " << group.spec.name << ": " << group.spec.count << " servers, speed "
+                   << group.spec.speed << ", " << jobNames[static_cast<int>(group.spec.jobs)] << " jobs";
+            if (group.spec.slots > 1) {
+                header << ", " << group.spec.slots << " slots";
+            }
+            header << "\n";
+        }
+    } else if (config.serverSlots > 1) {
+        header << "Server Slots: " << config.serverSlots << "\n";
+    }
+    if (groups[0].predictor) {
+        header << "Autoscaling: predictive (target wait " << config.targetWait
+               << " cycles, every " << config.scaleInterval << " cycles)\n";
+    }
+    if (groups[0].policy) {
+        header << "Dispatch Policy: " << groups[0].policy->name()
+               << " (server queue " << config.serverQueue << ")\n";
+    }
+    if (groups[0].flows) {
+        header << "Sticky Routing: " << config.sticky << " (" << groups[0].flows->capacity()
+               << " flows per pool, ttl " << config.stickyTtl << " cycles)\n";
+    }
+    if (config.clients > 0) {
+        header << "Clients: " << config.clients << "\n";
+    }
+    if (config.workload == "poisson") {
+        header << "Workload: poisson, " << config.arrivalRate << " arrivals per cycle\n";
+    } else if (config.workload == "diurnal") {
+        header << "Workload: diurnal, " << config.arrivalRate << " arrivals per cycle +/- "
+               << config.diurnalAmplitude * 100 << "% over " << config.diurnalPeriod << " cycles\n";
+    } else if (config.workload == "mmpp") {
+        header << "Workload: mmpp, rate/dwell";
+        for (size_t s = 0; s < config.mmppRates.size(); s++) {
+            header << (s == 0 ? " " : ", ") << config.mmppRates[s] << "/" << config.mmppDwell[s];
+        }
+        header << "\n";
+    }
+    if (config.durations == "pareto") {
+        header << "Durations: pareto (shape " << config.paretoShape << ", cap "
+               << config.durationCap << " cycles)\n";
+    }
+    header << "Initial Queue Size: " << queuedCount() << "\n";
+    header << "Task Time Ranges:\n";
+    header << "Streaming Jobs: " << config.streamMin << "-" << config.streamMax << " cycles\n";
+    header << "Processing Jobs: " << config.procMin << "-" << config.procMax << " cycles\n";
+    header << "=========================================\n\n";
+    logger.text(header.str());
+}
+
+/**
+ * @brief Populates the request queues with an initial set of random requests.
+ *
+ * @param numOfServers Number of servers to determine the initial number of requests.
+ */
+void LoadBalancer::populateReqQueue(int numOfServers) {
+    size_t initialRequests = static_cast<size_t>(numOfServers) * static_cast<size_t>(config.initialQueuePerServer);
+    std::vector<Request> initial(initialRequests);
+    genRandReqBatch(initial.data(), initial.size());
+    routeBatch(initial.data(), initial.size(), false);
+}
+
+/**
+ * @brief Creates every pool and its initial web servers.
+ *
+ * Slots are numbered pool by pool in configuration order. Every pool
+ * gets its own dispatch policy and predictive autoscaler when those
+ * are configured.
+ */
+void LoadBalancer::createWebServers() {
+    std::vector<ServerClass> classes = config.pools();
+    groups.resize(classes.size());
+    for (size_t g = 0; g < groups.size(); g++) {
+        ServerGroup& group = groups[g];
+        group.spec = classes[g];
+        group.policy = DispatchPolicy::create(config.dispatch, config.seed + g);
+        if (config.autoscale == "predictive") {
+            group.predictor.reset(new PredictiveScaler(config, group.spec.slots));
+        }
+        if (config.sticky != "off") {
+            group.flows.reset(new FlowTable(config.stickyFlows, config.stickyTtl));
+        }
+    }
+
+    // Specialized pools take their job type; the rest take anything
+    for (int streaming = 0; streaming < 2; streaming++) {
+        JobAffinity own = streaming ? JobAffinity::Streaming : JobAffinity::Processing;
+        for (size_t g = 0; g < groups.size(); g++) {
+            if (groups[g].spec.jobs == own) {
+                routes[streaming].push_back(g);
+            }
+        }
+        for (size_t g = 0; routes[streaming].empty() && g < groups.size(); g++) {
+            if (groups[g].spec.jobs == JobAffinity::Any) {
+                routes[streaming].push_back(g);
+            }
+        }
+    }
+
+    for (size_t g = 0; g < groups.size(); g++) {
+        for (int i = 0; i < groups[g].spec.count; i++) {
+            addServer(g);
+        }
+        initialNumServers += groups[g].spec.count;
+    }
+}
+
+/**
+ * @brief Adds one server to a pool.
+ *
+ * A new slot's weight is taken from the configured weights, cycling
+ * through them by slot index, and its speed from the pool's class;
+ * reused slots keep theirs.
+ *
+ * @param g Pool index.
+ */
+void LoadBalancer::addServer(size_t g) {
+    ServerGroup& group = groups[g];
+    size_t index = group.draining.findLast();
+    if (index != IdleServerSet::NONE) {
+        group.draining.markBusy(index);
+        group.active.markIdle(index);
+        group.busyLanes += webServers[index].laneCount() - webServers[index].freeLanes();
+        if (webServers[index].freeLanes() > 0) {
+            group.idle.markIdle(index);
+        }
+    } else if ((index = group.free.findFirst()) != IdleServerSet::NONE) {
+        group.free.markBusy(index);
+        group.active.markIdle(index);
+        group.idle.markIdle(index);
+    } else {
+        index = webServers.size();
+        double weight = config.weights.empty() ? 1.0 : config.weights[index % config.weights.size()];
+        webServers.add(weight, group.spec.speed, group.spec.slots);
+        laneCompletion.resize(webServers.laneCount(), 0);
+        serverDrainCycle.push_back(0);
+        slotGroup.push_back(static_cast<uint32_t>(g));
+        slotGeneration.push_back(0);
+        for (ServerGroup& other : groups) {
+            other.idle.pushBack(false);
+            other.active.pushBack(false);
+            other.draining.pushBack(false);
+            other.free.pushBack(false);
+            if (other.policy) {
+                other.policy->resize(webServers.size());
+            }
+        }
+        group.idle.markIdle(index);
+        group.active.markIdle(index);
+    }
+
+    if (group.policy) {
+        updatePolicy(index);
+    }
+}
+
+/**
+ * @brief Takes one server out of a pool without dropping work.
+ *
+ * Requests moved back from a draining server's local queue are no
+ * longer counted as processed. With several lanes per server, the
+ * highest server with room may still be running requests; it is then
+ * the highest active server that drains.
+ *
+ * @param g Pool index.
+ */
+void LoadBalancer::removeServer(size_t g) {
+    ServerGroup& group = groups[g];
+    size_t index = group.idle.findLast();
+    if (index != IdleServerSet::NONE && webServers[index].isNotActive()) {
+        group.idle.markBusy(index);
+        group.active.markBusy(index);
+        group.free.markIdle(index);
+    } else {
+        index = group.active.findLast();
+        if (index == IdleServerSet::NONE) {
+            return;
+        }
+        WebServer server = webServers[index];
+        totalRequestsProcessed -= static_cast<int>(server.moveQueuedTo(group.queue));
+        int last = currentClockCycle;
+        for (size_t lane = server.getFirstLane(); lane < server.getFirstLane() + server.laneCount(); lane++) {
+            if (webServers.isLaneBusy(lane)) {
+                last = std::max(last, laneCompletion[lane]);
+                group.busyLanes--;
+            }
+        }
+        serverDrainCycle[index] = last;
+        group.idle.markBusy(index);
+        group.active.markBusy(index);
+        group.draining.markIdle(index);
+    }
+    slotGeneration[index]++;
+
+    if (group.policy) {
+        updatePolicy(index);
+    }
+}
+
+/**
+ * @brief Returns the number of servers that accept requests.
+ *
+ * @return Active server count over every pool, excluding draining and free slots.
+ */
+int LoadBalancer::activeServerCount() const {
+    size_t count = 0;
+    for (const ServerGroup& group : groups) {
+        count += group.active.count();
+    }
+    return static_cast<int>(count);
+}
+
+/**
+ * @brief Returns the number of requests waiting in every pool's queue.
+ *
+ * @return Total queue length.
+ */
+size_t LoadBalancer::queuedCount() const {
+    size_t count = 0;
+    for (const ServerGroup& group : groups) {
+        count += group.queue.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Picks the pool for a request.
+ *
+ * A pool's load is its queued requests plus busy lanes divided by its
+ * active lanes times their speed; ties go to the earlier pool.
+ *
+ * @param req Request to route.
+ * @return Pool index.
+ */
+size_t LoadBalancer::route(const Request& req) const {
+    const std::vector<size_t>& candidates = routes[req.isStreamingJob()];
+    size_t best = candidates[0];
+    double bestLoad = 0;
+    for (size_t c = 0; c < candidates.size(); c++) {
+        const ServerGroup& group = groups[candidates[c]];
+        size_t active = group.active.count();
+        double load = static_cast<double>(group.queue.size() + group.busyLanes)
+                    / (std::max<size_t>(active, 1) * group.spec.slots * group.spec.speed);
+        if (c == 0 || load < bestLoad) {
+            best = candidates[c];
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Queues requests on the pools chosen by route().
+ *
+ * With a single pool the whole batch is copied in one step.
+ *
+ * @param batch Requests to queue.
+ * @param n Number of requests.
+ * @param arrivals True to count them as arrivals for predictive scaling.
+ */
+void LoadBalancer::routeBatch(const Request* batch, size_t n, bool arrivals) {
+    if (groups.size() == 1) {
+        groups[0].queue.pushBatch(batch, n);
+        if (arrivals && groups[0].predictor) {
+            groups[0].predictor->recordArrivals(n);
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        ServerGroup& group = groups[route(batch[i])];
+        group.queue.push(batch[i]);
+        if (arrivals && group.predictor) {
+            group.predictor->recordArrivals(1);
+        }
+    }
+}
+
+/**
+ * @brief Queues the requests of a batch whose source IPs are not blocked.
+ *
+ * Runs of unblocked requests are routed together.
+ *
+ * @param batch Arriving requests.
+ * @param n Number of requests.
+ */
+void LoadBalancer::admitBatch(const Request* batch, size_t n) {
+    PhaseScope<PHASE_TIMING> scope(profiler, Phase::Blocklist);
+    size_t start = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (isBlockedIP(batch[i].getIpIn())) {
+            routeBatch(batch + start, i - start, true);
+            blockedRequests++;
+            start = i + 1;
+        }
+    }
+    routeBatch(batch + start, n - start, true);
+}
+
+/**
+ * @brief Returns the pool name to show in scaling log lines.
+ *
+ * @param group Pool index.
+ * @return Name, or nullptr when there is only one pool.
+ */
+const char* LoadBalancer::poolName(size_t group) const {
+    return groups.size() > 1 ? groups[group].spec.name.c_str() : nullptr;
+}
+
+/**
+ * @brief Records that a server lane has started a request on this cycle.
+ *
+ * In event-driven mode this also schedules the completion event. A
+ * completion past INT_MAX is held at INT_MAX, which no run reaches.
+ *
+ * @param lane Lane running the request.
+ * @param processingTime Cycles the request takes on that lane.
+ */
+void LoadBalancer::scheduleCompletion(size_t lane, int processingTime) {
+    int done = processingTime > INT_MAX - currentClockCycle ? INT_MAX : currentClockCycle + processingTime;
+    laneCompletion[lane] = done;
+    if (eventDriven) {
+        completionEvents.emplace(done, static_cast<int>(lane));
+    }
+}
+
+/**
+ * @brief Generates a random packed IPv4 address.
+ *
+ * Uses the high 32 bits of one draw, so every octet is uniform.
+ *
+ * @return Random IP address as a packed IPv4 value.
+ */
+uint32_t LoadBalancer::generate_IP() {
+    return static_cast<uint32_t>(rng.next() >> 32);
+}
+
+/**
+ * @brief Generates a random request with a random IP, streaming flag, and processing time.
+ *
+ * @return Randomly generated Request object.
+ */
+Request LoadBalancer::genRandReq() {
+    Request req;
+    genRandReqBatch(&req, 1);
+    return req;
+}
+
+/**
+ * @brief Fills a block of random requests arriving on the current cycle.
+ *
+ * @param out Destination array with room for n requests.
+ * @param n Number of requests to generate.
+ */
+void LoadBalancer::genRandReqBatch(Request* out, size_t n) {
+    workload.generate(out, n, currentClockCycle, rng);
+}
+
+/**
+ * @brief Checks if an IP address falls within a blocked range.
+ *
+ * @param ip Packed IPv4 address to check.
+ * @return true if the IP is blocked, false otherwise.
+ */
+bool LoadBalancer::isBlockedIP(uint32_t ip) {
+    return blocklist.contains(ip);
+}
+
+/**
+ * @brief Splits the server pool into shards ticked on separate threads.
+ *
+ * @param numShards Number of shards; 1 or less disables sharding.
+ */
+void LoadBalancer::setNumShards(int numShards) {
+    if (numShards > 1) {
+        shardPool.reset(new ShardPool(numShards));
+    } else {
+        shardPool.reset();
+    }
+}
+
+/**
+ * @brief Replaces the default blocked range with prefixes from a file.
+ *
+ * On failure the current blocklist is left empty.
+ *
+ * @param path Path of a file with one CIDR prefix per line.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the blocklist was loaded.
+ */
+bool LoadBalancer::loadBlocklist(const std::string& path, std::string& error) {
+    if (!blocklist.loadFile(path, error)) {
+        blocklist.clear();
+        return false;
+    }
+    logger.text("Blocklist: " + std::to_string(blocklist.size()) + " ranges from " + path + "\n\n");
+    return true;
+}
+
+
+/**
+ * @brief Replays requests from a binary trace instead of generating them.
+ *
+ * @param path Path of a trace written by TraceWriter.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the trace was opened.
+ */
+bool LoadBalancer::loadTrace(const std::string& path, std::string& error) {
+    std::unique_ptr<TraceReader> reader(new TraceReader());
+    if (!reader->open(path, error)) {
+        return false;
+    }
+    logger.text("Trace: " + std::to_string(reader->size()) + " requests from " + path + "\n\n");
+    trace = std::move(reader);
+    return true;
+}
+
+/**
+ * @brief Saves the complete simulation state to a file.
+ *
+ * The file records the scheduler mode, dispatch policy, autoscaling
+ * mode, sticky routing mode and pool names first so that restoreCheckpoint() can refuse a
+ * mismatched run.
+ * Values are stored in native byte order.
+ *
+ * @param path Checkpoint path; written atomically.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the checkpoint was written.
+ */
+bool LoadBalancer::saveCheckpoint(const std::string& path, std::string& error) const {
+    CheckpointWriter out;
+    out.putArray(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.put(CHECKPOINT_VERSION);
+    out.put<uint8_t>(eventDriven);
+    out.putArray(config.dispatch.data(), config.dispatch.size());
+    out.put<uint8_t>(groups[0].predictor != nullptr);
+    out.putArray(config.sticky.data(), config.sticky.size());
+    out.put<uint64_t>(groups.size());
+    for (const ServerGroup& group : groups) {
+        out.putArray(group.spec.name.data(), group.spec.name.size());
+    }
+
+    out.put(currentClockCycle);
+    out.put(initialNumServers);
+    out.put(totalRequestsProcessed);
+    out.put(blockedRequests);
+    // Past the end of this run the next arrival is only a sentinel, so a
+    // resumed run draws its own
+    out.put(nextArrivalCycle <= runningTime ? nextArrivalCycle : 0);
+    out.put<uint64_t>(nextArrivalCycle <= runningTime ? nextArrivalCount : 0);
+    out.put(workload.state());
+
+    uint64_t rngState[4];
+    rng.getState(rngState);
+    out.putArray(rngState, 4);
+    out.putArray(laneCompletion.data(), laneCompletion.size());
+    out.putArray(serverDrainCycle.data(), serverDrainCycle.size());
+    out.putArray(slotGroup.data(), slotGroup.size());
+    out.putArray(slotGeneration.data(), slotGeneration.size());
+    out.put(stickyHits);
+    out.put(stickyFallbacks);
+    out.put(stickyRehomes);
+    out.put(stickyPins);
+
+    std::vector<uint8_t> slots(webServers.size());
+    for (size_t i = 0; i < slots.size(); i++) {
+        const ServerGroup& group = groups[slotGroup[i]];
+        slots[i] = group.active.isIdle(i) ? SLOT_ACTIVE
+                 : group.draining.isIdle(i) ? SLOT_DRAINING : SLOT_FREE;
+    }
+    out.putArray(slots.data(), slots.size());
+    webServers.save(out);
+
+    for (const ServerGroup& group : groups) {
+        out.put(group.scaleCooldown);
+        std::vector<Request> queued(group.queue.size());
+        group.queue.peekBatch(queued.data(), queued.size());
+        out.putArray(queued.data(), queued.size());
+        if (group.predictor) {
+            group.predictor->save(out);
+        }
+        if (group.flows) {
+            group.flows->save(out);
+        }
+        std::vector<uint64_t> policyState;
+        if (group.policy) {
+            group.policy->saveState(policyState);
+        }
+        out.putArray(policyState.data(), policyState.size());
+    }
+
+    for (int t = 0; t < 2; t++) {
+        intervalWait[t].save(out);
+        intervalLatency[t].save(out);
+        runWait[t].save(out);
+        runLatency[t].save(out);
+    }
+    out.put<uint64_t>(trace ? trace->tell() : NO_TRACE);
+
+    return out.save(path, error);
+}
+
+/**
+ * @brief Replaces the simulation state with one saved by saveCheckpoint().
+ *
+ * The idle, active, draining and free bitmaps, the dispatch policies'
+ * indexes and the completion heap are rebuilt from the restored slots
+ * rather than stored. On failure the simulation is left in an
+ * unspecified state and must not be run.
+ *
+ * @param path Checkpoint path.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the state was restored.
+ */
+bool LoadBalancer::restoreCheckpoint(const std::string& path, std::string& error) {
+    CheckpointReader in;
+    if (!in.load(path, error)) {
+        return false;
+    }
+
+    std::vector<char> magic;
+    uint32_t version = 0;
+    in.getArray(magic);
+    in.get(version);
+    if (!in.ok() || magic.size() != sizeof(CHECKPOINT_MAGIC)
+        || std::memcmp(magic.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0
+        || version != CHECKPOINT_VERSION) {
+        error = path + " is not a checkpoint of this version";
+        return false;
+    }
+
+    uint8_t savedEventDriven = 0;
+    std::vector<char> savedDispatch;
+    uint8_t savedPredictive = 0;
+    std::vector<char> savedSticky;
+    uint64_t savedGroups = 0;
+    in.get(savedEventDriven);
+    in.getArray(savedDispatch);
+    in.get(savedPredictive);
+    in.getArray(savedSticky);
+    in.get(savedGroups);
+    std::string dispatch(savedDispatch.begin(), savedDispatch.end());
+    std::string sticky(savedSticky.begin(), savedSticky.end());
+    std::string pools;
+    for (uint64_t g = 0; g < savedGroups && in.ok(); g++) {
+        std::vector<char> name;
+        in.getArray(name);
+        pools += (g > 0 ? ";" : "") + std::string(name.begin(), name.end());
+    }
+    std::string configuredPools;
+    for (size_t g = 0; g < groups.size(); g++) {
+        configuredPools += (g > 0 ? ";" : "") + groups[g].spec.name;
+    }
+    if (!in.ok()) {
+        error = "checkpoint " + path + " is truncated";
+        return false;
+    }
+    if ((savedEventDriven != 0) != eventDriven) {
+        error = "checkpoint " + path + " was written by the "
+              + (savedEventDriven ? "event-driven" : "ticked") + " scheduler";
+        return false;
+    }
+    if (dispatch != config.dispatch) {
+        error = "checkpoint " + path + " was written with dispatch " + dispatch;
+        return false;
+    }
+    if ((savedPredictive != 0) != (groups[0].predictor != nullptr)) {
+        error = "checkpoint " + path + " was written with autoscale "
+              + (savedPredictive ? "predictive" : "threshold");
+        return false;
+    }
+    if (sticky != config.sticky) {
+        error = "checkpoint " + path + " was written with sticky " + sticky;
+        return false;
+    }
+    if (pools != configuredPools) {
+        error = "checkpoint " + path + " was written with server pools " + pools;
+        return false;
+    }
+
+    in.get(currentClockCycle);
+    in.get(initialNumServers);
+    in.get(totalRequestsProcessed);
+    in.get(blockedRequests);
+    in.get(nextArrivalCycle);
+    uint64_t savedArrivalCount = 0;
+    uint32_t workloadState = 0;
+    in.get(savedArrivalCount);
+    in.get(workloadState);
+    nextArrivalCount = static_cast<size_t>(savedArrivalCount);
+
+    std::vector<uint64_t> rngState;
+    std::vector<uint8_t> slots;
+    in.getArray(rngState);
+    in.getArray(laneCompletion);
+    in.getArray(serverDrainCycle);
+    in.getArray(slotGroup);
+    in.getArray(slotGeneration);
+    in.get(stickyHits);
+    in.get(stickyFallbacks);
+    in.get(stickyRehomes);
+    in.get(stickyPins);
+    in.getArray(slots);
+    bool ok = in.ok() && webServers.load(in);
+
+    std::vector<std::vector<uint64_t>> policyStates(groups.size());
+    for (size_t g = 0; ok && g < groups.size(); g++) {
+        ServerGroup& group = groups[g];
+        std::vector<Request> queued;
+        in.get(group.scaleCooldown);
+        in.getArray(queued);
+        group.queue.clear();
+        group.queue.pushBatch(queued.data(), queued.size());
+        if (group.predictor) {
+            ok = group.predictor->load(in);
+        }
+        if (ok && group.flows) {
+            ok = group.flows->load(in, webServers.size());
+        }
+        in.getArray(policyStates[g]);
+    }
+    for (int t = 0; t < 2; t++) {
+        ok = ok && intervalWait[t].load(in) && intervalLatency[t].load(in)
+                && runWait[t].load(in) && runLatency[t].load(in);
+    }
+    uint64_t tracePosition = NO_TRACE;
+    in.get(tracePosition);
+
+    size_t numSlots = webServers.size();
+    ok = ok && in.ok() && rngState.size() == 4 && slots.size() == numSlots
+         && laneCompletion.size() == webServers.laneCount() && serverDrainCycle.size() == numSlots
+         && slotGroup.size() == numSlots && slotGeneration.size() == numSlots;
+    for (size_t i = 0; ok && i < numSlots; i++) {
+        ok = slotGroup[i] < groups.size() && slots[i] <= SLOT_FREE;
+    }
+    ok = ok && workload.setState(workloadState);
+    if (!ok) {
+        error = "checkpoint " + path + " is truncated or corrupt";
+        return false;
+    }
+
+    if ((tracePosition != NO_TRACE) != (trace != nullptr)) {
+        error = "checkpoint " + path + (trace ? " was written without a trace" : " needs its trace");
+        return false;
+    }
+    if (trace && !trace->seek(tracePosition)) {
+        error = "checkpoint " + path + " is past the end of the trace";
+        return false;
+    }
+
+    rng.setState(rngState.data());
+
+    completionEvents = decltype(completionEvents)();
+    for (size_t g = 0; g < groups.size(); g++) {
+        ServerGroup& group = groups[g];
+        group.idle = IdleServerSet();
+        group.active = IdleServerSet();
+        group.draining = IdleServerSet();
+        group.free = IdleServerSet();
+        group.busyLanes = 0;
+        for (size_t i = 0; i < numSlots; i++) {
+            bool own = slotGroup[i] == g;
+            bool room = webServers[i].freeLanes() > 0;
+            group.idle.pushBack(own && slots[i] == SLOT_ACTIVE && room);
+            group.active.pushBack(own && slots[i] == SLOT_ACTIVE);
+            group.draining.pushBack(own && slots[i] == SLOT_DRAINING);
+            group.free.pushBack(own && slots[i] == SLOT_FREE);
+            if (own && slots[i] == SLOT_ACTIVE) {
+                group.busyLanes += webServers[i].laneCount() - webServers[i].freeLanes();
+            }
+        }
+        if (group.policy) {
+            group.policy = DispatchPolicy::create(config.dispatch, config.seed + g);
+            group.policy->resize(numSlots);
+        }
+    }
+    for (size_t i = 0; i < numSlots; i++) {
+        if (groups[slotGroup[i]].policy) {
+            updatePolicy(i);
+        }
+    }
+    for (size_t lane = 0; eventDriven && lane < webServers.laneCount(); lane++) {
+        if (webServers.isLaneBusy(lane)) {
+            completionEvents.emplace(laneCompletion[lane], static_cast<int>(lane));
+        }
+    }
+    for (size_t g = 0; g < groups.size(); g++) {
+        const std::unique_ptr<DispatchPolicy>& policy = groups[g].policy;
+        if (policy ? !policy->restoreState(policyStates[g]) : !policyStates[g].empty()) {
+            error = "checkpoint " + path + " has an invalid dispatch policy state";
+            return false;
+        }
+    }
+
+    logger.text("Restored from " + path + " at cycle " + std::to_string(currentClockCycle) + "\n\n");
+    return true;
+}
+
+/**
+ * @brief Decides which way a server pool should scale.
+ *
+ * The pool grows when its queue holds more than scaleUpFactor requests
+ * per server lane and shrinks when it holds fewer than scaleDownFactor
+ * per lane.
+ *
+ * @param group Pool index.
+ * @return 1 to add a server, -1 to remove one, 0 to leave the pool as is.
+ */
+int LoadBalancer::scaleDirection(size_t group) const {
+    long queueSize = groups[group].queue.size();
+    int numServers = static_cast<int>(groups[group].active.count());
+    long numLanes = static_cast<long>(numServers) * groups[group].spec.slots;
+
+    if (queueSize > static_cast<long>(config.scaleUpFactor) * numLanes) {
+        return 1;
+    }
+    if (queueSize < static_cast<long>(config.scaleDownFactor) * numLanes && numServers > 1) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Dynamically scales the number of servers based on the queue size.
+ *
+ * If a pool's queue is too large, a new server is added to it. If the queue is too small,
+ * a server is removed, respecting a cooldown period to avoid frequent scaling.
+ */
+void LoadBalancer::scaleServers() {
+    PhaseScope<PHASE_TIMING> scope(profiler, Phase::Scaling);
+    for (size_t g = 0; g < groups.size(); g++) {
+        ServerGroup& group = groups[g];
+        if (group.predictor) {
+            scalePredictive(g);
+            continue;
+        }
+        if (group.scaleCooldown > 0) {
+            group.scaleCooldown--;
+            continue;
+        }
+
+        int direction = scaleDirection(g);
+
+        if (direction > 0) {
+            addServer(g);
+            group.scaleCooldown = config.scaleWait;
+            logger.scale(currentClockCycle, true, activeServerCount(), 1,
+                         poolName(g), static_cast<int>(group.active.count()));
+            if (metrics) {
+                metrics->recordScale(true, 1);
+            }
+        }
+        else if (direction < 0) {
+            removeServer(g);
+            group.scaleCooldown = config.scaleWait;
+            logger.scale(currentClockCycle, false, activeServerCount(), 1,
+                         poolName(g), static_cast<int>(group.active.count()));
+            if (metrics) {
+                metrics->recordScale(false, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Resizes a pool to its predictive autoscaler's target at the
+ *        end of each of its windows.
+ *
+ * Several servers may be added or removed in one decision, logged as a
+ * single scaling event.
+ *
+ * @param g Pool index.
+ */
+void LoadBalancer::scalePredictive(size_t g) {
+    ServerGroup& group = groups[g];
+    if (!group.predictor->isDecisionCycle(currentClockCycle)) {
+        return;
+    }
+
+    int current = static_cast<int>(group.active.count());
+    int target = group.predictor->decide(current, group.queue.size());
+    for (int i = current; i < target; i++) {
+        addServer(g);
+    }
+    for (int i = current; i > target; i--) {
+        removeServer(g);
+    }
+    if (target != current) {
+        logger.scale(currentClockCycle, target > current, activeServerCount(),
+                     std::abs(target - current), poolName(g), target);
+        if (metrics) {
+            metrics->recordScale(target > current, std::abs(target - current));
+        }
+    }
+}
+
+/**
+ * @brief Draws the number of requests arriving on a cycle.
+ *
+ * @param cycle Cycle after the one of the previous draw.
+ * @return Number of arrivals from the workload.
+ */
+size_t LoadBalancer::drawArrivals(int cycle) {
+    return workload.arrivals(cycle, rng);
+}
+
+/**
+ * @brief Generates new requests for the current cycle and queues
+ *        those whose source IP is not blocked.
+ *
+ * Requests are generated and admitted in fixed-size batches on the
+ * stack, so a burst of any size allocates nothing.
+ *
+ * @param count Number of requests.
+ */
+void LoadBalancer::addArrivals(size_t count) {
+    Request batch[ARRIVAL_BATCH];
+    while (count > 0) {
+        size_t n = std::min(count, ARRIVAL_BATCH);
+        genRandReqBatch(batch, n);
+        admitBatch(batch, n);
+        count -= n;
+    }
+}
+
+/**
+ * @brief Queues every trace record whose arrival cycle has come,
+ *        blocking those from blocked IPs.
+ *
+ * With a single pool, runs of unblocked records are copied into its
+ * queue straight from the mapped trace.
+ */
+void LoadBalancer::addTraceArrivals() {
+    const Request* batch;
+    size_t taken;
+    while ((taken = trace->takeUntil(currentClockCycle, batch)) > 0) {
+        admitBatch(batch, taken);
+    }
+}
+
+/**
+ * @brief Queues every fed request whose arrival cycle has come,
+ *        blocking those from blocked IPs.
+ */
+void LoadBalancer::addFeedArrivals() {
+    const Request* run;
+    size_t n;
+    while ((n = feed->frontRun(run, feed->size())) > 0) {
+        size_t due = 0;
+        while (due < n && run[due].getArrivalTime() <= currentClockCycle) {
+            due++;
+        }
+        admitBatch(run, due);
+        feed->drop(due);
+        if (due < n) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Takes arrivals only from feedArrivals() from now on.
+ */
+void LoadBalancer::enableFeed() {
+    feed.reset(new RingBuffer<Request>());
+}
+
+/**
+ * @brief Adds requests for the feed to deliver on their arrival cycles.
+ *
+ * @param batch Requests sorted by arrival cycle, none before the
+ *        arrivals already fed.
+ * @param n Number of requests.
+ */
+void LoadBalancer::feedArrivals(const Request* batch, size_t n) {
+    feed->pushBatch(batch, n);
+}
+
+/**
+ * @brief Removes the oldest requests from the pool queues.
+ *
+ * Pools are emptied in order until max requests are taken.
+ *
+ * @param out Receives the requests.
+ * @param max Room in out.
+ * @return Number of requests taken.
+ */
+size_t LoadBalancer::takeQueued(Request* out, size_t max) {
+    size_t taken = 0;
+    for (ServerGroup& group : groups) {
+        taken += group.queue.popBatch(out + taken, max - taken);
+    }
+    return taken;
+}
+
+/**
+ * @brief Queues requests taken from another balancer.
+ *
+ * They are routed like arrivals but not checked against the blocklist
+ * again, and keep their original arrival cycle.
+ *
+ * @param batch Requests to queue.
+ * @param n Number of requests.
+ */
+void LoadBalancer::acceptQueued(const Request* batch, size_t n) {
+    routeBatch(batch, n, true);
+}
+
+/**
+ * @brief Adds this run's queue waits and latencies to two histograms.
+ *
+ * @param wait Receives the queue waits of every started request.
+ * @param latency Receives the latencies of every completed request.
+ */
+void LoadBalancer::mergeLatency(LatencyHistogram& wait, LatencyHistogram& latency) const {
+    for (int t = 0; t < 2; t++) {
+        wait.merge(runWait[t]);
+        wait.merge(intervalWait[t]);
+        latency.merge(runLatency[t]);
+        latency.merge(intervalLatency[t]);
+    }
+}
 
 /**
- * @brief Constructs a LoadBalancer with the specified number of servers and runtime.
+ * @brief Redirects progress lines and the final summary.
  *
- * Initializes random seed, creates the initial web servers, populates the request queue,
- * and opens a log file for recording simulation events.
+ * @param out Destination stream, or nullptr to print nothing.
+ */
+void LoadBalancer::setConsole(std::ostream* out) {
+    console = out;
+}
+
+/**
+ * @brief Returns the current counters of the simulation.
  *
- * @param numServers Initial number of web servers.
- * @param runTime Number of clock cycles to run the simulation.
+ * @return Summary of the run so far; final once Run() returns.
  */
-LoadBalancer::LoadBalancer(int numServers, int runTime)
-    : currentClockCycle(0),
-      runningTime(runTime),
-      initialNumServers(numServers),
-      scaleCooldown(0),
-      totalRequestsProcessed(0),
-      blockedRequests(0)
-{
-    std::srand(static_cast<unsigned>(time(nullptr)));
-    createWebServers(numServers);
-    populateReqQueue(numServers);
+RunSummary LoadBalancer::getSummary() const {
+    RunSummary summary;
+    summary.initialServers = initialNumServers;
+    summary.finalServers = activeServerCount();
+    summary.processed = totalRequestsProcessed;
+    summary.blocked = blockedRequests;
+    summary.endingQueue = queuedCount();
+    summary.cycles = currentClockCycle;
+
+    LatencyHistogram wait;
+    LatencyHistogram latency;
+    mergeLatency(wait, latency);
+    summary.waitP99 = wait.percentile(0.99);
+    summary.latencyP50 = latency.percentile(0.5);
+    summary.latencyP99 = latency.percentile(0.99);
+    return summary;
+}
 
-    logFile.open("log.txt");
-    logFile << "===== LOAD BALANCER SIMULATION START =====\n";
-    logFile << "Initial Servers: " << numServers << "\n";
-    logFile << "Planned Clock Cycles: " << runTime << "\n";
-    logFile << "Initial Queue Size: " << requestQueue.size() << "\n";
-    logFile << "Task Time Ranges:\n";
-    logFile << "Streaming Jobs: " << STREAM_MIN << "-" << STREAM_MAX << " cycles\n";
-    logFile << "Processing Jobs: " << PROC_MIN << "-" << PROC_MAX << " cycles\n";
-    logFile << "=========================================\n\n";
+/**
+ * @brief Sets how much detail the log records.
+ *
+ * @param level Most detailed level to record.
+ */
+void LoadBalancer::setLogLevel(LogLevel level) {
+    logger.setLevel(level);
+}
 
+/**
+ * @brief Keeps only one of every n periodic state lines in the log.
+ *
+ * @param n Sampling interval; 1 keeps every line.
+ */
+void LoadBalancer::setLogSampling(int n) {
+    logger.setSampling(n);
 }
 
 /**
- * @brief Populates the request queue with an initial set of random requests.
+ * @brief Enables submit() with a bounded lock-free ingress queue.
  *
- * @param numOfServers Number of servers to determine the initial number of requests.
+ * @param capacity Maximum number of requests waiting to be drained.
  */
-void LoadBalancer::populateReqQueue(int numOfServers) {
-    int initialRequests = numOfServers * 20;
-    for (int i = 0; i < initialRequests; i++) {
-        requestQueue.push(genRandReq());
-    }
+void LoadBalancer::enableIngress(size_t capacity) {
+    ingress.reset(new MpmcQueue<Request>(capacity));
 }
 
 /**
- * @brief Creates the initial web servers and assigns each a unique server ID.
+ * @brief Submits a request from any thread.
  *
- * @param numOfServers Number of servers to create.
+ * @param req Request to submit.
+ * @return false if ingress is disabled or the ingress queue is full.
  */
-void LoadBalancer::createWebServers(int numOfServers) {
-    for (int i = 0; i < numOfServers; i++) {
-        webServers.emplace_back(i);
+bool LoadBalancer::submit(const Request& req) {
+    if (ingress && ingress->tryPush(req)) {
+        return true;
     }
+    rejectedSubmissions.fetch_add(1, std::memory_order_relaxed);
+    return false;
 }
 
 /**
- * @brief Generates a random IPv4 address as a string.
+ * @brief Moves up to one queue capacity of submitted requests into
+ *        the request queues, blocking those from blocked IPs.
  *
- * @return Random IP address in the format "x.x.x.x".
+ * Requests are drained INGRESS_BATCH at a time and admitted as a batch.
+ * Whatever is past the capacity waits for the next cycle.
  */
-std::string LoadBalancer::generate_IP() {
-    return std::to_string(rand() % 256) + "." +
-           std::to_string(rand() % 256) + "." +
-           std::to_string(rand() % 256) + "." +
-           std::to_string(rand() % 256);
+void LoadBalancer::drainIngress() {
+    if (!ingress) {
+        return;
+    }
+
+    Request batch[INGRESS_BATCH];
+    size_t budget = ingress->capacity();
+    size_t taken;
+    while (budget > 0 && (taken = ingress->tryPopBatch(batch, std::min(budget, INGRESS_BATCH))) > 0) {
+        admitBatch(batch, taken);
+        budget -= taken;
+    }
 }
 
 /**
- * @brief Generates a random request with a random IP, streaming flag, and processing time.
+ * @brief Assigns queued requests to idle servers in pool order.
  *
- * @return Randomly generated Request object.
+ * Servers with room are taken from the idle bitmap from the lowest index
+ * up, which matches the order of a full scan over webServers while only
+ * touching the servers that receive work; a server keeps receiving
+ * requests until all its lanes are busy. Every server with room takes at
+ * least one request, so up to that many are read in place from the
+ * queue, one contiguous run at a time, and removed together; the pass
+ * repeats while room remains.
+ * In event-driven mode each assignment also schedules the lane's
+ * completion event. When a dispatch policy is configured it chooses the
+ * servers instead, and with sticky routing pinned clients go to their
+ * home servers first.
  */
-Request LoadBalancer::genRandReq() {
-    std::string ipIn = generate_IP();
-    std::string ipOut = generate_IP();
+void LoadBalancer::dispatchRequests() {
+    PhaseScope<PHASE_TIMING> scope(profiler, Phase::Dispatch);
+    for (size_t g = 0; g < groups.size(); g++) {
+        ServerGroup& group = groups[g];
+        if (group.flows) {
+            dispatchSticky(g);
+            continue;
+        }
+        if (group.policy) {
+            dispatchWithPolicy(g);
+            continue;
+        }
 
-    bool isStreaming = (rand() % 2 == 0);
-    int processingTime = isStreaming
-    ? (rand() % (4) + 12)
-    : (rand() % (11) + 30);
+        size_t remaining;
+        while ((remaining = std::min(group.idle.count(), group.queue.size())) > 0) {
+            size_t i = 0;
 
+            while (remaining > 0) {
+                const Request* run;
+                size_t taken = group.queue.frontRun(run, remaining);
+                remaining -= taken;
 
-    return Request(ipIn, ipOut, isStreaming, processingTime, currentClockCycle);
+                for (size_t b = 0; b < taken; b++) {
+                    const Request& req = run[b];
+                    i = group.idle.findNext(i);
+                    WebServer server = webServers[i];
+                    size_t lane = server.processRequest(req);
+                    if (server.freeLanes() == 0) {
+                        group.idle.markBusy(i);
+                    }
+                    group.busyLanes++;
+                    recordStart(req);
+                    scheduleCompletion(lane, server.getTimeRemaining(lane));
+                    totalRequestsProcessed++;
+                }
+                group.queue.drop(taken);
+            }
+        }
+    }
 }
 
 /**
- * @brief Checks if an IP address falls within a blocked range.
+ * @brief Assigns a pool's queued requests to the servers chosen by its policy.
  *
- * @param ip IP address to check.
- * @return true if the IP is blocked, false otherwise.
+ * Every assignment updates the policy, so each request sees the load
+ * left by the ones before it.
+ *
+ * @param g Pool index.
  */
-bool LoadBalancer::isBlockedIP(const std::string& ip) {
-    int firstOctet = std::stoi(ip.substr(0, ip.find('.')));
-    return firstOctet >= 192 && firstOctet <= 200;
+void LoadBalancer::dispatchWithPolicy(size_t g) {
+    ServerGroup& group = groups[g];
+    size_t index;
+    while (!group.queue.empty() && (index = group.policy->select()) != DispatchPolicy::NONE) {
+        assignToServer(index, group.queue.front());
+        group.queue.pop();
+    }
 }
 
+/**
+ * @brief Assigns a pool's queued requests, sending pinned clients to
+ *        their home servers.
+ *
+ * A pinned client goes to its home server when that server has room.
+ * Otherwise the request falls back to the server the pool would choose
+ * anyway, its policy's pick or the lowest idle server, and the client
+ * keeps its home. A client whose home was removed since it was pinned
+ * is rehomed to the server it gets now. The pin check is one flow
+ * table lookup, with no scan of the pool.
+ *
+ * @param g Pool index.
+ */
+void LoadBalancer::dispatchSticky(size_t g) {
+    ServerGroup& group = groups[g];
+    bool pinAll = config.sticky == "all";
+    while (!group.queue.empty()) {
+        const Request& req = group.queue.front();
+        bool pinned = pinAll || req.isStreamingJob();
+        FlowTable::Flow* flow = pinned ? group.flows->find(req.getIpIn(), currentClockCycle) : nullptr;
+        bool atHome = flow && slotGeneration[flow->server] == flow->generation;
+
+        size_t index = DispatchPolicy::NONE;
+        if (atHome) {
+            WebServer home = webServers[flow->server];
+            bool room = group.policy
+                      ? home.freeLanes() > 0 || home.queuedCount() < static_cast<size_t>(config.serverQueue)
+                      : home.freeLanes() > 0;
+            if (room) {
+                index = flow->server;
+            }
+        }
+        if (index == DispatchPolicy::NONE) {
+            index = group.policy ? group.policy->select() : group.idle.findFirst();
+            if (index == DispatchPolicy::NONE) {
+                break;
+            }
+        }
+
+        if (!pinned) {
+            // Unpinned jobs are placed as without sticky routing
+        } else if (!flow) {
+            group.flows->insert(req.getIpIn(), static_cast<uint32_t>(index), slotGeneration[index],
+                                currentClockCycle);
+            stickyPins++;
+        } else if (!atHome) {
+            flow->server = static_cast<uint32_t>(index);
+            flow->generation = slotGeneration[index];
+            stickyRehomes++;
+        } else if (index == flow->server) {
+            stickyHits++;
+        } else {
+            stickyFallbacks++;
+        }
+
+        assignToServer(index, req);
+        group.queue.pop();
+    }
+}
 
 /**
- * @brief Dynamically scales the number of servers based on the queue size.
+ * @brief Gives a request to a server, starting it if a lane is free
+ *        and queueing it locally otherwise.
  *
- * If the queue is too large, a new server is added. If the queue is too small, a server
- * is removed, respecting a cooldown period to avoid frequent scaling.
+ * The estimated drain cycle spreads the request's time over the
+ * server's lanes.
+ *
+ * @param index Server index.
+ * @param req Request to assign.
  */
-void LoadBalancer::scaleServers() {
-    if (scaleCooldown > 0) {
-        scaleCooldown--;
-        return;
+void LoadBalancer::assignToServer(size_t index, const Request& req) {
+    WebServer server = webServers[index];
+    int lanes = static_cast<int>(server.laneCount());
+    int64_t drain = std::max(serverDrainCycle[index], currentClockCycle)
+                  + (static_cast<int64_t>(server.serviceTime(req)) + lanes - 1) / lanes;
+    serverDrainCycle[index] = static_cast<int>(std::min<int64_t>(drain, INT_MAX));
+
+    ServerGroup& group = groups[slotGroup[index]];
+    if (server.freeLanes() > 0) {
+        size_t lane = server.processRequest(req);
+        if (server.freeLanes() == 0) {
+            group.idle.markBusy(index);
+        }
+        group.busyLanes++;
+        recordStart(req);
+        scheduleCompletion(lane, server.getTimeRemaining(lane));
+    } else {
+        server.enqueue(req);
+    }
+
+    totalRequestsProcessed++;
+    if (group.policy) {
+        updatePolicy(index);
+    }
+}
+
+/**
+ * @brief Handles a server lane that just finished its request.
+ *
+ * A draining server is released once its last lane finishes.
+ *
+ * @param lane Lane that finished.
+ */
+void LoadBalancer::completeRequest(size_t lane) {
+    size_t index = webServers.serverOfLane(lane);
+    WebServer server = webServers[index];
+    ServerGroup& group = groups[slotGroup[index]];
+    recordCompletion(server.getRequest(lane));
+    if (group.predictor) {
+        group.predictor->recordCompletion(server.serviceTime(server.getRequest(lane)));
     }
+    size_t started;
+    if (group.draining.isIdle(index)) {
+        if (server.isNotActive()) {
+            group.draining.markBusy(index);
+            group.free.markIdle(index);
+        }
+    } else if ((started = server.startQueued()) != WebServer::NO_LANE) {
+        recordStart(server.getRequest(started));
+        scheduleCompletion(started, server.getTimeRemaining(started));
+    } else {
+        group.busyLanes--;
+        group.idle.markIdle(index);
+    }
+
+    if (group.policy) {
+        updatePolicy(index);
+    }
+}
 
-    int queueSize = requestQueue.size();
-    int numServers = webServers.size();
+/**
+ * @brief Records the queue wait of a request starting on this cycle.
+ *
+ * @param req Request being started.
+ */
+void LoadBalancer::recordStart(const Request& req) {
+    intervalWait[req.isStreamingJob()].record(currentClockCycle - req.getArrivalTime());
+}
 
-    if (queueSize > 25 * numServers) {
-        webServers.emplace_back(numServers);
-        scaleCooldown = SCALE_WAIT;
-        logFile << "[Cycle " << currentClockCycle << "] "
-            << "SCALE UP: Added server. Total servers = "
-            << webServers.size() << "\n";
-    } 
-    else if (queueSize < 15 * numServers && numServers > 1) {
-        webServers.pop_back();
-        scaleCooldown = SCALE_WAIT;
-        logFile << "[Cycle " << currentClockCycle << "] "
-                << "SCALE DOWN: Removed server. Total servers = "
-                << webServers.size() << "\n";
+/**
+ * @brief Records the end-to-end latency of a request finishing on this cycle.
+ *
+ * @param req Request that finished.
+ */
+void LoadBalancer::recordCompletion(const Request& req) {
+    uint32_t latency = currentClockCycle - req.getArrivalTime();
+    intervalLatency[req.isStreamingJob()].record(latency);
+    if (metrics) {
+        metrics->recordLatency(latency);
     }
 }
 
+/**
+ * @brief Reports a server's current load to the dispatch policy.
+ *
+ * @param index Server index.
+ */
+void LoadBalancer::updatePolicy(size_t index) {
+    WebServer server = webServers[index];
+    ServerGroup& group = groups[slotGroup[index]];
+    ServerLoad load;
+    load.outstanding = server.laneCount() - server.freeLanes() + server.queuedCount();
+    load.capacity = group.active.isIdle(index)
+                  ? server.laneCount() + static_cast<size_t>(config.serverQueue) : 0;
+    load.drainCycle = serverDrainCycle[index];
+    load.weight = server.getWeight();
+    group.policy->update(index, load);
+}
+
 /**
  * @brief Runs the main simulation loop for the load balancer.
  *
@@ -150,79 +1423,519 @@ void LoadBalancer::scaleServers() {
  * - Processes requests on active servers.
  * - Assigns queued requests to available servers.
  * - Scales servers up or down if necessary.
- * - Logs state to a file and prints summary every 50 cycles.
+ * - Logs state to a file and prints summary every logInterval cycles.
+ *
+ * In event-driven mode the same steps run only on cycles where
+ * something can change.
  */
 void LoadBalancer::Run() {
-    while (currentClockCycle < runningTime) {
-        currentClockCycle++;
+    publishMetrics();
+    if (eventDriven) {
+        runEventDriven();
+    } else {
+        runTicked(runningTime);
+    }
+    finishRun();
+}
 
-        if (rand() % 100 < 90) {
-            Request req = genRandReq();
-            if (!isBlockedIP(req.getIpIn())) {
-                requestQueue.push(req);
-            } else {
-                blockedRequests++;
-            }
+/**
+ * @brief Runs the ticked loop up to a cycle.
+ *
+ * @param cycle Cycle to stop at; never past the configured cycle count.
+ */
+void LoadBalancer::advanceTo(int cycle) {
+    runTicked(std::min(cycle, runningTime));
+}
+
+/**
+ * @brief Writes the sticky routing counters as one summary line.
+ *
+ * The home rate is the share of requests from clients already pinned
+ * that ran on their home server.
+ *
+ * @param out Destination stream.
+ */
+void LoadBalancer::writeStickySummary(std::ostream& out) const {
+    uint64_t evicted = 0;
+    size_t live = 0;
+    for (const ServerGroup& group : groups) {
+        evicted += group.flows->evictions();
+        live += group.flows->liveCount(currentClockCycle);
+    }
+    uint64_t returning = stickyHits + stickyFallbacks + stickyRehomes;
+    out << "Sticky Routing: " << stickyHits << " home, " << stickyFallbacks << " fallback, "
+        << stickyRehomes << " rehomed, " << stickyPins << " new, " << evicted << " evicted, "
+        << live << " live";
+    if (returning > 0) {
+        std::ostringstream rate;
+        rate << std::fixed << std::setprecision(1) << 100.0 * stickyHits / returning;
+        out << " (" << rate.str() << "% home)";
+    }
+    out << "\n";
+}
+
+/**
+ * @brief Ends the run: writes the final checkpoint, prints the summary
+ *        and closes the log.
+ */
+void LoadBalancer::finishRun() {
+    // The interval histograms are still open here, so a resumed run
+    // logs the same interval percentiles as an uninterrupted one
+    if (!config.checkpointPath.empty() && !isCheckpointCycle()) {
+        writeCheckpoint();
+    }
+
+    if (console) {
+        *console << "\nSimulation complete\n";
+        *console << "Initial Servers: " << initialNumServers << "\n";
+        *console << "Final Servers: " << activeServerCount() << "\n";
+        *console << "Requests Processed: " << totalRequestsProcessed << "\n";
+        *console << "Blocked Requests: " << blockedRequests << "\n";
+        if (ingress) {
+            *console << "Rejected Submissions: " << rejectedSubmissions.load() << "\n";
+        }
+        if (groups[0].flows) {
+            writeStickySummary(*console);
+        }
+    }
+
+    closeLatencyInterval();
+    uint32_t wait[3][4];
+    uint32_t latency[3][4];
+    latencyPercentiles(runWait, wait);
+    latencyPercentiles(runLatency, latency);
+
+    if (console) {
+        *console << "Queue Wait p50/p90/p99/p99.9: ";
+        writePercentiles(*console, wait[0]);
+        *console << " cycles\nLatency p50/p90/p99/p99.9: ";
+        writePercentiles(*console, latency[0]);
+        *console << " cycles\n";
+        if (PHASE_TIMING) {
+            profiler.writeBreakdown(*console);
+        }
+    }
+    if (PHASE_TIMING && !config.profileTracePath.empty()) {
+        std::string error;
+        if (!profiler.writeChromeTrace(config.profileTracePath, error)) {
+            std::cerr << "Warning: profile trace: " << error << "\n";
+        } else if (profiler.dropped() > 0) {
+            std::cerr << "Warning: profile trace " << config.profileTracePath << " holds the first "
+                      << PhaseProfiler::MAX_TRACE_EVENTS << " phases; " << profiler.dropped()
+                      << " more were dropped\n";
         }
+    }
+
+    std::ostringstream footer;
+    footer << "\n===== SIMULATION END =====\n";
+    footer << "Ending Queue Size: " << queuedCount() << "\n";
+    footer << "Final Servers: " << activeServerCount() << "\n";
+    footer << "Total Requests Processed: " << totalRequestsProcessed << "\n";
+    footer << "Total Blocked Requests: " << blockedRequests << "\n";
+    footer << "Completed Requests: " << (runLatency[0].count() + runLatency[1].count()) << "\n";
+    if (groups[0].flows) {
+        writeStickySummary(footer);
+    }
+    const char* types[3] = {"all", "streaming", "processing"};
+    for (int t = 0; t < 3; t++) {
+        footer << "Queue Wait p50/p90/p99/p99.9 (" << types[t] << "): ";
+        writePercentiles(footer, wait[t]);
+        footer << "\n";
+    }
+    for (int t = 0; t < 3; t++) {
+        footer << "Latency p50/p90/p99/p99.9 (" << types[t] << "): ";
+        writePercentiles(footer, latency[t]);
+        footer << "\n";
+    }
+    footer << "==========================\n";
+    logger.text(footer.str());
+
+    logger.close();
+    if (series) {
+        std::string error;
+        if (!series->close(error)) {
+            std::cerr << "Warning: series " << config.seriesPath << ": " << error << "\n";
+        }
+        series.reset();
+    }
+}
+
+/**
+ * @brief Advances every busy lane by one cycle and completes the
+ *        ones that finish.
+ *
+ * The pool's vectorized kernel ticks every lane and returns a bitmask
+ * of the lanes that finished, which are then completed in lane order.
+ * Finished lanes are held busy until their turn, so a server whose
+ * lanes finish together sees them free up one at a time, as the event
+ * loop does. With sharding enabled the shards are ticked in parallel
+ * and their finished lanes are completed once all are done.
+ */
+void LoadBalancer::tickServers() {
+    PhaseScope<PHASE_TIMING> scope(profiler, Phase::Tick);
+    if (shardPool) {
+        shardPool->tick(webServers, finishedLanes);
+    } else {
+        finishedLanes.resize(webServers.blocks());
+        webServers.tick(0, webServers.blocks(), finishedLanes.data());
+    }
 
-        for (auto& server : webServers) {
-            server.handleRequest();
+    for (size_t block = 0; webServers.laneCount() > webServers.size() && block < finishedLanes.size(); block++) {
+        for (uint64_t bits = finishedLanes[block]; bits != 0; bits &= bits - 1) {
+            webServers.holdLane(block * ServerPool::BLOCK + __builtin_ctzll(bits));
+        }
+    }
+    for (size_t block = 0; block < finishedLanes.size(); block++) {
+        for (uint64_t bits = finishedLanes[block]; bits != 0; bits &= bits - 1) {
+            size_t lane = block * ServerPool::BLOCK + __builtin_ctzll(bits);
+            webServers[webServers.serverOfLane(lane)].finishRequest(lane);
+            completeRequest(lane);
         }
+    }
+}
+
+/**
+ * @brief Runs the simulation one clock cycle at a time.
+ *
+ * Every server is ticked on every cycle.
+ *
+ * @param until Cycle to stop at.
+ */
+void LoadBalancer::runTicked(int until) {
+    PhaseScope<PHASE_TIMING> loop(profiler, Phase::Other);
+    while (currentClockCycle < until) {
+        currentClockCycle++;
 
-        for (auto& server : webServers) {
-            if (server.isNotActive() && !requestQueue.empty()) {
-                Request req = requestQueue.front();
-                requestQueue.pop();
-                server.processRequest(req);
-                totalRequestsProcessed++;
+        {
+            PhaseScope<PHASE_TIMING> scope(profiler, Phase::Arrivals);
+            if (trace) {
+                addTraceArrivals();
+            } else if (feed) {
+                addFeedArrivals();
+            } else if (size_t arrivals = drawArrivals(currentClockCycle)) {
+                addArrivals(arrivals);
             }
         }
+        drainIngress();
+
+        tickServers();
+
+        dispatchRequests();
 
         scaleServers();
+        publishMetrics();
 
-        if (currentClockCycle % 50 == 0) {
+        if (currentClockCycle % config.logInterval == 0) {
+            PhaseScope<PHASE_TIMING> scope(profiler, Phase::Logging);
             logState();
             printSummary();
         }
+
+        if (isCheckpointCycle()) {
+            writeCheckpoint();
+        }
+    }
+}
+
+/**
+ * @brief Draws the cycle of the next arrival after the current cycle.
+ *
+ * Performs one arrival draw per cycle, in the same order as
+ * runTicked(), so both modes consume identical random sequences. The
+ * number of requests due is left in nextArrivalCount.
+ * A replayed trace supplies the cycle directly; arrivals stamped at or
+ * before the current cycle are taken on the next one.
+ *
+ * @return Next arrival cycle, or runningTime + 1 if none remain.
+ */
+int LoadBalancer::drawNextArrival() {
+    if (trace) {
+        return std::max(trace->nextArrival(runningTime + 1), currentClockCycle + 1);
+    }
+    for (int cycle = currentClockCycle + 1; cycle <= runningTime; cycle++) {
+        nextArrivalCount = drawArrivals(cycle);
+        if (nextArrivalCount > 0) {
+            return cycle;
+        }
+    }
+    return runningTime + 1;
+}
+
+/**
+ * @brief Computes the next cycle at which anything can change.
+ *
+ * Stale completion events left behind by removed servers are discarded.
+ * Between events the queue and pool are unchanged, so a scaling decision
+ * can only fire once the cooldown runs out.
+ *
+ * @return Earliest pending event cycle.
+ */
+int LoadBalancer::nextEventCycle() {
+    int next = nextArrivalCycle;
+
+    while (!completionEvents.empty()) {
+        int cycle = completionEvents.top().first;
+        size_t lane = completionEvents.top().second;
+        if (lane < webServers.laneCount() && webServers.isLaneBusy(lane)
+            && laneCompletion[lane] == cycle) {
+            next = std::min(next, cycle);
+            break;
+        }
+        completionEvents.pop();
+    }
+
+    next = std::min(next, (currentClockCycle / config.logInterval + 1) * config.logInterval);
+    if (config.checkpointEvery > 0) {
+        next = std::min(next, (currentClockCycle / config.checkpointEvery + 1) * config.checkpointEvery);
+    }
+
+    for (size_t g = 0; g < groups.size(); g++) {
+        const ServerGroup& group = groups[g];
+        if (group.predictor) {
+            next = std::min(next, group.predictor->nextDecisionCycle(currentClockCycle));
+        } else if (scaleDirection(g) != 0) {
+            next = std::min(next, currentClockCycle + group.scaleCooldown + 1);
+        }
+
+        bool canDispatch = group.policy ? group.policy->hasCapacity() : group.idle.count() > 0;
+        if (canDispatch && !group.queue.empty()) {
+            next = std::min(next, currentClockCycle + 1);
+        }
+    }
+
+    if (ingress && !ingress->empty()) {
+        next = std::min(next, currentClockCycle + 1);
+    }
+
+    return next;
+}
+
+/**
+ * @brief Accounts for cycles the event loop jumps over.
+ *
+ * Skipped cycles only wind down the scaling cooldowns.
+ *
+ * @param cycles Number of cycles skipped.
+ */
+void LoadBalancer::skipCycles(int cycles) {
+    for (ServerGroup& group : groups) {
+        group.scaleCooldown -= std::min(group.scaleCooldown, cycles);
+    }
+}
+
+/**
+ * @brief Runs the simulation as a discrete-event loop.
+ *
+ * Each server's completion cycle is pushed into a min-heap when it is
+ * assigned a request. The clock then jumps straight to the next arrival,
+ * completion, scaling decision or logging point instead of ticking every
+ * server on every cycle.
+ */
+void LoadBalancer::runEventDriven() {
+    PhaseScope<PHASE_TIMING> loop(profiler, Phase::Other);
+    // A restored run keeps the arrival it had already drawn
+    if (nextArrivalCycle <= currentClockCycle) {
+        nextArrivalCycle = drawNextArrival();
     }
 
-    std::cout << "\nSimulation complete\n";
-    std::cout << "Initial Servers: " << initialNumServers << "\n";
-    std::cout << "Final Servers: " << webServers.size() << "\n";
-    std::cout << "Requests Processed: " << totalRequestsProcessed << "\n";
-    std::cout << "Blocked Requests: " << blockedRequests << "\n";
+    while (currentClockCycle < runningTime) {
+        int next = nextEventCycle();
+        if (next > runningTime) {
+            skipCycles(runningTime - currentClockCycle);
+            currentClockCycle = runningTime;
+            break;
+        }
+
+        skipCycles(next - currentClockCycle - 1);
+        currentClockCycle = next;
 
-    logFile << "\n===== SIMULATION END =====\n";
-    logFile << "Ending Queue Size: " << requestQueue.size() << "\n";
-    logFile << "Final Servers: " << webServers.size() << "\n";
-    logFile << "Total Requests Processed: " << totalRequestsProcessed << "\n";
-    logFile << "Total Blocked Requests: " << blockedRequests << "\n";
-    logFile << "==========================\n";
+        if (currentClockCycle == nextArrivalCycle) {
+            PhaseScope<PHASE_TIMING> scope(profiler, Phase::Arrivals);
+            if (trace) {
+                addTraceArrivals();
+            } else {
+                addArrivals(nextArrivalCount);
+            }
+            nextArrivalCycle = drawNextArrival();
+        }
+        drainIngress();
+
+        {
+            PhaseScope<PHASE_TIMING> scope(profiler, Phase::Tick);
+            while (!completionEvents.empty()
+                   && completionEvents.top().first == currentClockCycle) {
+                size_t lane = completionEvents.top().second;
+                completionEvents.pop();
+                if (lane < webServers.laneCount() && webServers.isLaneBusy(lane)
+                    && laneCompletion[lane] == currentClockCycle) {
+                    webServers[webServers.serverOfLane(lane)].finishRequest(lane);
+                    completeRequest(lane);
+                }
+            }
+        }
+
+        dispatchRequests();
+
+        scaleServers();
+        publishMetrics();
+
+        if (currentClockCycle % config.logInterval == 0) {
+            PhaseScope<PHASE_TIMING> scope(profiler, Phase::Logging);
+            logState();
+            printSummary();
+        }
 
+        if (isCheckpointCycle()) {
+            writeCheckpoint();
+        }
+    }
+}
+/**
+ * @brief Opens the configured metrics endpoints and starts exporting.
+ *
+ * An endpoint that cannot be opened is reported and skipped, like an
+ * unwritable log file.
+ */
+void LoadBalancer::startMetrics() {
+    if (config.metricsPort == 0 && config.metricsStatsd.empty()) {
+        return;
+    }
+    metrics.reset(new Metrics());
+    exporter.reset(new MetricsExporter(*metrics));
+    std::string error;
+    if (config.metricsPort > 0 && !exporter->listenHttp(config.metricsPort, error)) {
+        std::cerr << "Warning: " << error << "\n";
+    }
+    if (!config.metricsStatsd.empty()
+        && !exporter->pushStatsd(config.metricsStatsd, config.metricsInterval, error)) {
+        std::cerr << "Warning: " << error << "\n";
+    }
+    publishMetrics();
+    exporter->start();
+}
 
-    logFile.close();
+/**
+ * @brief Publishes the current state to the live metrics, if enabled.
+ *
+ * Called once per simulated cycle; the exporter thread picks the values
+ * up whenever it is scraped or pushes.
+ */
+void LoadBalancer::publishMetrics() {
+    if (!metrics) {
+        return;
+    }
+    size_t idle = 0;
+    size_t draining = 0;
+    for (const ServerGroup& group : groups) {
+        idle += group.idle.count();
+        draining += group.draining.count();
+    }
+    metrics->publish(currentClockCycle, queuedCount(), static_cast<size_t>(activeServerCount()),
+                     idle, draining, totalRequestsProcessed, blockedRequests);
 }
 
 /**
  * @brief Logs the current simulation state to the log file.
  */
 void LoadBalancer::logState() {
-    logFile << "[Cycle " << currentClockCycle << "] "
-            << "Servers: " << webServers.size()
-            << ", Queue: " << requestQueue.size()
-            << ", Processed: " << totalRequestsProcessed
-            << ", Blocked: " << blockedRequests
-            << "\n";
+    logger.state(currentClockCycle, activeServerCount(), queuedCount(),
+                 totalRequestsProcessed, blockedRequests);
+    logLatency();
+}
+
+/**
+ * @brief Logs the latency percentiles of the interval just ended and
+ *        folds the interval histograms into the run totals.
+ *
+ * With a series open, the state and the percentiles for all jobs are
+ * also appended to it as one row.
+ */
+void LoadBalancer::logLatency() {
+    uint32_t wait[3][4];
+    uint32_t latency[3][4];
+    latencyPercentiles(intervalWait, wait);
+    logger.latency(false, wait);
+    latencyPercentiles(intervalLatency, latency);
+    logger.latency(true, latency);
+    closeLatencyInterval();
+
+    if (series) {
+        int64_t row[SERIES_COLUMN_COUNT] = {
+            currentClockCycle, activeServerCount(), static_cast<int64_t>(queuedCount()),
+            totalRequestsProcessed, blockedRequests,
+            wait[0][0], wait[0][1], wait[0][2], wait[0][3],
+            latency[0][0], latency[0][1], latency[0][2], latency[0][3]
+        };
+        std::string error;
+        if (!series->append(row, error)) {
+            std::cerr << "Warning: series " << config.seriesPath << ": " << error << "\n";
+            series.reset();
+        }
+    }
+}
+
+/**
+ * @brief Creates the configured time series, if any.
+ *
+ * A series that cannot be created is reported and skipped, like an
+ * unwritable log file.
+ */
+void LoadBalancer::openSeries() {
+    if (config.seriesPath.empty()) {
+        return;
+    }
+    std::vector<std::string> columns(SERIES_COLUMNS, SERIES_COLUMNS + SERIES_COLUMN_COUNT);
+    series.reset(new TimeSeriesWriter());
+    std::string error;
+    if (!series->open(config.seriesPath, columns, error)) {
+        std::cerr << "Warning: " << error << "\n";
+        series.reset();
+    }
+}
+
+/**
+ * @brief Folds the interval histograms into the run totals.
+ */
+void LoadBalancer::closeLatencyInterval() {
+    for (int t = 0; t < 2; t++) {
+        runWait[t].merge(intervalWait[t]);
+        runLatency[t].merge(intervalLatency[t]);
+        intervalWait[t].reset();
+        intervalLatency[t].reset();
+    }
 }
 
 /**
  * @brief Prints a summary of the current simulation state to the console.
  */
 void LoadBalancer::printSummary() {
-    std::cout << "[Cycle " << currentClockCycle << "] "
-              << "Servers: " << webServers.size()
-              << ", Queue: " << requestQueue.size()
-              << ", Processed: " << totalRequestsProcessed
-              << ", Blocked: " << blockedRequests
-              << "\n";
-}
\ No newline at end of file
+    if (!config.progress || !console) {
+        return;
+    }
+    *console << "[Cycle " << currentClockCycle << "] "
+             << "Servers: " << activeServerCount()
+             << ", Queue: " << queuedCount()
+             << ", Processed: " << totalRequestsProcessed
+             << ", Blocked: " << blockedRequests
+             << "\n";
+}
+
+/**
+ * @brief Writes the configured checkpoint file, warning on failure.
+ */
+void LoadBalancer::writeCheckpoint() {
+    std::string error;
+    if (!saveCheckpoint(config.checkpointPath, error)) {
+        std::cerr << "Warning: " << error << "\n";
+    }
+}
+
+/**
+ * @brief Checks whether a periodic checkpoint is due on this cycle.
+ *
+ * @return true if checkpoint-every is set and the cycle is a multiple of it.
+ */
+bool LoadBalancer::isCheckpointCycle() const {
+    return !config.checkpointPath.empty() && config.checkpointEvery > 0
+        && currentClockCycle % config.checkpointEvery == 0;
+}
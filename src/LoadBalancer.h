@@ -4,9 +4,94 @@
 #include <queue>
 #include <vector>
 #include <string>
+#include <utility>
+#include <functional>
 #include "Request.h"
 #include "WebServer.h"
-#include <fstream>
+#include "ServerPool.h"
+#include "IdleServerSet.h"
+#include "Blocklist.h"
+#include "RingBuffer.h"
+#include "ShardPool.h"
+#include "MpmcQueue.h"
+#include "Random.h"
+#include "AsyncLogger.h"
+#include "SimConfig.h"
+#include "DispatchPolicy.h"
+#include "LatencyHistogram.h"
+#include "PredictiveScaler.h"
+#include "TraceReader.h"
+#include "CheckpointFile.h"
+#include "Metrics.h"
+#include "MetricsExporter.h"
+#include "TimeSeriesWriter.h"
+#include "Workload.h"
+#include "FlowTable.h"
+#include "PhaseProfiler.h"
+#include <memory>
+#include <atomic>
+#include <ostream>
+
+/**
+ * @brief Final counters of a finished simulation run.
+ */
+struct RunSummary {
+    int initialServers;
+    int finalServers;
+    int processed;
+    int blocked;
+    size_t endingQueue;
+    int cycles;
+    uint32_t waitP99;
+    uint32_t latencyP50;
+    uint32_t latencyP99;
+};
+
+/**
+ * @brief One pool of servers of the same class.
+ *
+ * Requests are routed to a pool on arrival and wait in its queue. Each
+ * pool dispatches and scales on its own; its bitmaps span every slot of
+ * the shared ServerPool, with only the pool's own slots ever set.
+ */
+struct ServerGroup {
+    /** Class of the pool's servers */
+    ServerClass spec;
+
+    /** Requests routed to this pool awaiting a server */
+    RingBuffer<Request> queue;
+
+    /** Active servers with a free lane, i.e. those first-idle dispatch may use */
+    IdleServerSet idle;
+
+    /**
+     * Active servers. Slots never leave their pool: a slot is active,
+     * draining (finishing its last request before release) or free for
+     * reuse by the pool's next scale-up.
+     */
+    IdleServerSet active;
+
+    /** Servers finishing their last request */
+    IdleServerSet draining;
+
+    /** Released slots available for reuse */
+    IdleServerSet free;
+
+    /** Policy choosing the server for each request, or null for first-idle dispatch */
+    std::unique_ptr<DispatchPolicy> policy;
+
+    /** Load-estimating autoscaler, or null for threshold scaling */
+    std::unique_ptr<PredictiveScaler> predictor;
+
+    /** Client pins for sticky routing, or null when routing is not sticky */
+    std::unique_ptr<FlowTable> flows;
+
+    /** Cooldown counter to prevent rapid scaling */
+    int scaleCooldown = 0;
+
+    /** Lanes running a request on the pool's active servers */
+    size_t busyLanes = 0;
+};
 
 /**
  * @class LoadBalancer
@@ -16,14 +101,25 @@
  * of web servers, dynamically scaling the number of servers
  * based on request queue size. It also blocks requests from
  * restricted IP ranges and logs system state over time.
+ * Servers may be split into several pools of different classes,
+ * each with its own queue and scaling.
  */
 class LoadBalancer {
 private:
-    /** Queue of incoming requests awaiting processing */
-    std::queue<Request> requestQueue;
+    /** Server pools, each with its own request queue */
+    std::vector<ServerGroup> groups;
+
+    /** Pools accepting each job type, indexed by isStreamingJob() */
+    std::vector<size_t> routes[2];
+
+    /** State of every web server slot, stored as parallel arrays */
+    ServerPool webServers;
 
-    /** Collection of active web servers */
-    std::vector<WebServer> webServers;
+    /** Pool owning each slot */
+    std::vector<uint32_t> slotGroup;
+
+    /** Times each slot was taken out of service, so stale sticky pins can be told apart */
+    std::vector<uint32_t> slotGeneration;
 
     /** Current simulation clock cycle */
     int currentClockCycle;
@@ -34,11 +130,11 @@ private:
     /** Initial number of web servers at startup */
     int initialNumServers;
 
-    /** Cooldown counter to prevent rapid scaling */
-    int scaleCooldown;
+    /** Simulation parameters: thresholds, job ranges, arrival rate, logging */
+    SimConfig config;
 
-    /** Number of cycles to wait between scaling events */
-    const int SCALE_WAIT = 3;
+    /** Arrival and duration models built from config */
+    Workload workload;
 
     /** Total number of successfully processed requests */
     int totalRequestsProcessed;
@@ -46,8 +142,112 @@ private:
     /** Total number of blocked requests */
     int blockedRequests;
 
+    /** Sticky routing: requests sent to their home server, sent elsewhere
+     *  because it was full, moved to a new home because theirs was removed,
+     *  and clients pinned for the first time */
+    uint64_t stickyHits;
+    uint64_t stickyFallbacks;
+    uint64_t stickyRehomes;
+    uint64_t stickyPins;
+
+    /** True if Run() uses the discrete-event scheduler instead of ticking every cycle */
+    bool eventDriven;
+
+    /** Min-heap of (completion cycle, lane) pairs used in event-driven mode */
+    std::priority_queue<std::pair<int, int>,
+                        std::vector<std::pair<int, int>>,
+                        std::greater<std::pair<int, int>>> completionEvents;
+
+    /** Completion cycle of the request running on each server lane */
+    std::vector<int> laneCompletion;
+
+    /** Cycle of the next request arrival in event-driven mode */
+    int nextArrivalCycle;
+
+    /** Number of requests arriving at nextArrivalCycle */
+    size_t nextArrivalCount;
+
+    /** Lock-free queue of requests submitted by other threads, or null */
+    std::unique_ptr<MpmcQueue<Request>> ingress;
+
+    /** Number of submit() calls rejected because the ingress queue was full */
+    std::atomic<long> rejectedSubmissions;
+
+    /** Number of ingress requests moved to the request queue per batch */
+    static constexpr size_t INGRESS_BATCH = 256;
+
+    /** Number of arriving requests generated and admitted per batch */
+    static constexpr size_t ARRIVAL_BATCH = 256;
+
+    /** Random generator owned by this simulation */
+    Random rng;
+
+    /** Worker threads ticking shards of the pool, or null when single-threaded */
+    std::unique_ptr<ShardPool> shardPool;
+
+    /** Bitmask of lanes that finished during the current tick, one word per block */
+    std::vector<uint64_t> finishedLanes;
+
+    /** Blocked source address ranges (192.0.0.0 - 200.255.255.255 by default) */
+    Blocklist blocklist;
+
+    /** Trace being replayed, or null when requests are generated */
+    std::unique_ptr<TraceReader> trace;
+
+    /** Requests handed in by feedArrivals(), or null when requests are generated */
+    std::unique_ptr<RingBuffer<Request>> feed;
+
+    /** Cycle at which each server finishes everything assigned to it */
+    std::vector<int> serverDrainCycle;
+
+    /** Queue wait of requests started in the current log interval, indexed by isStreamingJob() */
+    LatencyHistogram intervalWait[2];
+
+    /** Arrival-to-completion latency of requests finished in the current log interval */
+    LatencyHistogram intervalLatency[2];
+
+    /** Queue wait of every request started in earlier intervals */
+    LatencyHistogram runWait[2];
+
+    /** Arrival-to-completion latency of every request finished in earlier intervals */
+    LatencyHistogram runLatency[2];
+
     /**
-     * @brief Populates the request queue with initial requests.
+     * @brief Records the queue wait of a request starting on this cycle.
+     *
+     * @param req Request being started.
+     */
+    void recordStart(const Request& req);
+
+    /**
+     * @brief Records the end-to-end latency of a request finishing on this cycle.
+     *
+     * @param req Request that finished.
+     */
+    void recordCompletion(const Request& req);
+
+    /**
+     * @brief Logs the latency percentiles of the interval just ended and
+     *        folds the interval histograms into the run totals.
+     *
+     * Also appends the current row of the time series, if one is open.
+     */
+    void logLatency();
+
+    /**
+     * @brief Folds the interval histograms into the run totals.
+     */
+    void closeLatencyInterval();
+
+    /**
+     * @brief Writes the sticky routing counters as one summary line.
+     *
+     * @param out Destination stream.
+     */
+    void writeStickySummary(std::ostream& out) const;
+
+    /**
+     * @brief Populates the request queues with initial requests.
      *
      * The initial number of requests is proportional to the
      * number of web servers.
@@ -57,59 +257,453 @@ private:
     void populateReqQueue(int numOfServers);
 
     /**
-     * @brief Creates and initializes web servers.
+     * @brief Creates every pool and its initial web servers.
+     */
+    void createWebServers();
+
+    /**
+     * @brief Adds one server to a pool.
+     *
+     * Cancels a drain if one is in progress, otherwise reuses a free
+     * slot, and only grows webServers when neither exists.
      *
-     * @param numOfServers Number of web servers to create.
+     * @param group Pool index.
      */
-    void createWebServers(int numOfServers);
+    void addServer(size_t group);
+
+    /**
+     * @brief Takes one server out of a pool without dropping work.
+     *
+     * An idle server is released at once. Otherwise the highest busy
+     * server stops receiving requests and is released when its current
+     * request finishes; requests waiting in its local queue go back to
+     * the pool's queue.
+     *
+     * @param group Pool index.
+     */
+    void removeServer(size_t group);
+
+    /**
+     * @brief Returns the number of servers that accept requests.
+     *
+     * @return Active server count over every pool, excluding draining and free slots.
+     */
+    int activeServerCount() const;
+
+    /**
+     * @brief Returns the number of requests waiting in every pool's queue.
+     *
+     * @return Total queue length.
+     */
+    size_t queuedCount() const;
+
+    /**
+     * @brief Picks the pool for a request.
+     *
+     * Among the pools accepting the request's job type, the one with the
+     * fewest queued and running requests per unit of speed wins.
+     *
+     * @param req Request to route.
+     * @return Pool index.
+     */
+    size_t route(const Request& req) const;
+
+    /**
+     * @brief Queues requests on the pools chosen by route().
+     *
+     * @param batch Requests to queue.
+     * @param n Number of requests.
+     * @param arrivals True to count them as arrivals for predictive scaling.
+     */
+    void routeBatch(const Request* batch, size_t n, bool arrivals);
+
+    /**
+     * @brief Queues the requests of a batch whose source IPs are not blocked.
+     *
+     * @param batch Arriving requests.
+     * @param n Number of requests.
+     */
+    void admitBatch(const Request* batch, size_t n);
+
+    /**
+     * @brief Returns the pool name to show in scaling log lines.
+     *
+     * @param group Pool index.
+     * @return Name, or nullptr when there is only one pool.
+     */
+    const char* poolName(size_t group) const;
+
+    /**
+     * @brief Records that a server lane has started a request on this cycle.
+     *
+     * @param lane Lane running the request.
+     * @param processingTime Cycles the request takes on that lane.
+     */
+    void scheduleCompletion(size_t lane, int processingTime);
 
     /**
      * @brief Dynamically scales the number of web servers.
      *
      * Adds or removes servers based on queue size thresholds
-     * and enforces a cooldown between scaling events.
+     * and enforces a cooldown between scaling events. Every pool
+     * is scaled separately.
      */
     void scaleServers();
 
+    /**
+     * @brief Resizes a pool to its predictive autoscaler's target at the
+     *        end of each of its windows.
+     *
+     * @param group Pool index.
+     */
+    void scalePredictive(size_t group);
+
+    /**
+     * @brief Decides which way a server pool should scale.
+     *
+     * @param group Pool index.
+     * @return 1 to add a server, -1 to remove one, 0 to leave the pool as is.
+     */
+    int scaleDirection(size_t group) const;
+
+    /**
+     * @brief Draws the number of requests arriving on a cycle.
+     *
+     * @param cycle Cycle after the one of the previous draw.
+     * @return Number of arrivals from the workload.
+     */
+    size_t drawArrivals(int cycle);
+
+    /**
+     * @brief Generates new requests for the current cycle and queues
+     *        those whose source IP is not blocked.
+     *
+     * @param count Number of requests.
+     */
+    void addArrivals(size_t count);
+
+    /**
+     * @brief Queues every trace record whose arrival cycle has come,
+     *        blocking those from blocked IPs.
+     */
+    void addTraceArrivals();
+
+    /**
+     * @brief Queues every fed request whose arrival cycle has come,
+     *        blocking those from blocked IPs.
+     */
+    void addFeedArrivals();
+
+    /**
+     * @brief Moves up to one queue capacity of submitted requests into
+     *        the request queues, blocking those from blocked IPs.
+     */
+    void drainIngress();
+
+    /**
+     * @brief Assigns queued requests to idle servers in pool order.
+     *
+     * Idle servers come from the idle bitmaps, so the cost is
+     * proportional to the number of requests assigned.
+     */
+    void dispatchRequests();
+
+    /**
+     * @brief Assigns a pool's queued requests to the servers chosen by its policy.
+     *
+     * Runs until the queue is empty or no server has room.
+     *
+     * @param group Pool index.
+     */
+    void dispatchWithPolicy(size_t group);
+
+    /**
+     * @brief Assigns a pool's queued requests, sending pinned clients to
+     *        their home servers.
+     *
+     * Runs until the queue is empty or no server has room.
+     *
+     * @param group Pool index.
+     */
+    void dispatchSticky(size_t group);
+
+    /**
+     * @brief Gives a request to a server, starting it if the server is idle
+     *        and queueing it locally otherwise.
+     *
+     * @param index Server index.
+     * @param req Request to assign.
+     */
+    void assignToServer(size_t index, const Request& req);
+
+    /**
+     * @brief Handles a server lane that just finished its request.
+     *
+     * Starts the next locally queued request on the lane if there is one,
+     * otherwise marks the server as having room.
+     *
+     * @param lane Lane that finished.
+     */
+    void completeRequest(size_t lane);
+
+    /**
+     * @brief Reports a server's current load to its pool's dispatch policy.
+     *
+     * @param index Server index.
+     */
+    void updatePolicy(size_t index);
+
+    /**
+     * @brief Advances every busy server by one cycle and completes the
+     *        ones that finish.
+     */
+    void tickServers();
+
+    /**
+     * @brief Runs the simulation one clock cycle at a time.
+     *
+     * @param until Cycle to stop at.
+     */
+    void runTicked(int until);
+
+    /**
+     * @brief Accounts for cycles the event loop jumps over.
+     *
+     * @param cycles Number of cycles skipped.
+     */
+    void skipCycles(int cycles);
+
+    /**
+     * @brief Runs the simulation as a discrete-event loop.
+     *
+     * Server completions are kept in a min-heap keyed by cycle and the
+     * clock jumps straight to the next arrival, completion, scaling
+     * decision or logging point. Produces the same results as runTicked()
+     * for the same random sequence.
+     */
+    void runEventDriven();
+
+    /**
+     * @brief Draws the cycle of the next arrival after the current cycle.
+     *
+     * Consumes one arrival draw per cycle, exactly as runTicked() does.
+     * When replaying a trace, returns the next record's arrival instead.
+     *
+     * @return Next arrival cycle, or runningTime + 1 if none remain.
+     */
+    int drawNextArrival();
+
+    /**
+     * @brief Computes the next cycle at which anything can change.
+     *
+     * @return Earliest pending event cycle.
+     */
+    int nextEventCycle();
+
     /**
      * @brief Checks whether an IP address is blocked.
      *
-     * @param ip IP address to check.
+     * @param ip Packed IPv4 address to check.
      * @return true if the IP is blocked, false otherwise.
      */
-    bool isBlockedIP(const std::string& ip);
+    bool isBlockedIP(uint32_t ip);
+
+    /** Asynchronous writer for the simulation log */
+    AsyncLogger logger;
+
+    /** Live metrics, or null when no metrics endpoint is configured */
+    std::unique_ptr<Metrics> metrics;
+
+    /** Thread exporting metrics; declared after it so it stops first */
+    std::unique_ptr<MetricsExporter> exporter;
+
+    /** Columnar copy of the state lines, or null when no series is configured */
+    std::unique_ptr<TimeSeriesWriter> series;
 
-    /** Log file for recording simulation state */
-    std::ofstream logFile;
+    /** Time spent in each phase of the run loop; only used when PHASE_TIMING is set */
+    PhaseProfiler profiler;
+
+    /** Stream for progress and the final summary, or null for silence */
+    std::ostream* console;
 
     /**
      * @brief Logs the current system state to the log file.
      */
     void logState();
 
+    /**
+     * @brief Opens the configured metrics endpoints and starts exporting.
+     */
+    void startMetrics();
+
+    /**
+     * @brief Creates the configured time series, if any.
+     */
+    void openSeries();
+
+    /**
+     * @brief Publishes the current state to the live metrics, if enabled.
+     */
+    void publishMetrics();
+
     /**
      * @brief Prints a summary of the system state to stdout.
      */
     void printSummary();
 
+    /**
+     * @brief Writes the configured checkpoint file, warning on failure.
+     */
+    void writeCheckpoint();
+
+    /**
+     * @brief Checks whether a periodic checkpoint is due on this cycle.
+     *
+     * @return true if checkpoint-every is set and the cycle is a multiple of it.
+     */
+    bool isCheckpointCycle() const;
+
 public:
     /**
-     * @brief Constructs a LoadBalancer instance.
+     * @brief Constructs a LoadBalancer from a full configuration.
+     *
+     * Initializes web servers, populates the request queue,
+     * and prepares logging. The blocklist file named in the
+     * configuration is not loaded here; call loadBlocklist().
+     *
+     * @param config Simulation parameters.
+     */
+    explicit LoadBalancer(const SimConfig& config);
+
+    /**
+     * @brief Constructs a LoadBalancer instance with default parameters.
      *
      * Initializes web servers, populates the request queue,
      * and prepares logging.
      *
      * @param numServers Initial number of web servers.
      * @param runTime Number of clock cycles to simulate.
+     * @param seed Seed for the random generator; equal seeds give equal runs.
+     * @param eventDriven True to use the discrete-event scheduler.
+     */
+    LoadBalancer(int numServers, int runTime, uint64_t seed, bool eventDriven = false);
+
+    /**
+     * @brief Redirects progress lines and the final summary.
+     *
+     * @param out Destination stream, or nullptr to print nothing.
+     */
+    void setConsole(std::ostream* out);
+
+    /**
+     * @brief Returns the current counters of the simulation.
+     *
+     * @return Summary of the run so far; final once Run() returns.
      */
-    LoadBalancer(int numServers, int runTime);
+    RunSummary getSummary() const;
+
+    /**
+     * @brief Sets how much detail the log records.
+     *
+     * @param level Most detailed level to record.
+     */
+    void setLogLevel(LogLevel level);
+
+    /**
+     * @brief Keeps only one of every n periodic state lines in the log.
+     *
+     * @param n Sampling interval; 1 keeps every line.
+     */
+    void setLogSampling(int n);
+
+    /**
+     * @brief Enables submit() with a bounded lock-free ingress queue.
+     *
+     * Must be called before any producer thread starts submitting.
+     *
+     * @param capacity Maximum number of requests waiting to be drained.
+     */
+    void enableIngress(size_t capacity);
+
+    /**
+     * @brief Submits a request from any thread.
+     *
+     * The request enters requestQueue at the start of the next simulated
+     * cycle, after the blocklist check. Lock-free and safe to call from
+     * many producer threads while Run() is executing.
+     *
+     * @param req Request to submit.
+     * @return false if ingress is disabled or the ingress queue is full.
+     */
+    bool submit(const Request& req);
+
+    /**
+     * @brief Replaces the default blocked range with prefixes from a file.
+     *
+     * @param path Path of a file with one CIDR prefix per line.
+     * @param error Receives a description of the problem on failure.
+     * @return true if the blocklist was loaded.
+     */
+    bool loadBlocklist(const std::string& path, std::string& error);
+
+    /**
+     * @brief Replays requests from a binary trace instead of generating them.
+     *
+     * Must be called before Run(). The initial queue is left empty when the
+     * configuration names a trace, so the trace alone supplies the load.
+     *
+     * @param path Path of a trace written by TraceWriter.
+     * @param error Receives a description of the problem on failure.
+     * @return true if the trace was opened.
+     */
+    bool loadTrace(const std::string& path, std::string& error);
+
+    /**
+     * @brief Saves the complete simulation state to a file.
+     *
+     * Covers the clock, counters, random generator, request queue, every
+     * server slot, the dispatch policy, the autoscaler, the latency
+     * histograms and the trace position. Requests still waiting in the
+     * ingress queue are not included.
+     *
+     * @param path Checkpoint path; written atomically.
+     * @param error Receives a description of the problem on failure.
+     * @return true if the checkpoint was written.
+     */
+    bool saveCheckpoint(const std::string& path, std::string& error) const;
+
+    /**
+     * @brief Replaces the simulation state with one saved by saveCheckpoint().
+     *
+     * Must be called before Run(), after loadTrace() if a trace is
+     * replayed. Run() then continues from the saved cycle up to the
+     * configured cycle count, producing the same results as a run that
+     * was never interrupted. The checkpoint must come from the same
+     * scheduler mode, dispatch policy, autoscaling mode and server pools.
+     *
+     * @param path Checkpoint path.
+     * @param error Receives a description of the problem on failure.
+     * @return true if the state was restored.
+     */
+    bool restoreCheckpoint(const std::string& path, std::string& error);
+
+    /**
+     * @brief Splits the server pool into shards ticked on separate threads.
+     *
+     * Only the ticked loop is sharded; the event-driven scheduler does not
+     * tick servers. Arrivals, dispatch, scaling and the counters stay on the
+     * calling thread, so results match a single-threaded run.
+     *
+     * @param numShards Number of shards; 1 or less disables sharding.
+     */
+    void setNumShards(int numShards);
 
     /**
      * @brief Generates a random IPv4 address.
      *
-     * @return Random IP address as a string.
+     * @return Random IP address as a packed IPv4 value.
      */
-    std::string generate_IP();
+    uint32_t generate_IP();
 
     /**
      * @brief Generates a random request.
@@ -118,6 +712,14 @@ public:
      */
     Request genRandReq();
 
+    /**
+     * @brief Fills a block of random requests arriving on the current cycle.
+     *
+     * @param out Destination array with room for n requests.
+     * @param n Number of requests to generate.
+     */
+    void genRandReqBatch(Request* out, size_t n);
+
     /**
      * @brief Runs the load balancer simulation.
      *
@@ -125,6 +727,74 @@ public:
      * scales servers dynamically, and logs state.
      */
     void Run();
+
+    /**
+     * @brief Runs the ticked loop up to a cycle, for driving the
+     *        simulation in steps.
+     *
+     * Call finishRun() after the last step instead of Run().
+     *
+     * @param cycle Cycle to stop at; never past the configured cycle count.
+     */
+    void advanceTo(int cycle);
+
+    /**
+     * @brief Ends the run: writes the final checkpoint, prints the summary
+     *        and closes the log.
+     */
+    void finishRun();
+
+    /**
+     * @brief Takes arrivals only from feedArrivals() from now on.
+     *
+     * Must be called before the first step.
+     */
+    void enableFeed();
+
+    /**
+     * @brief Adds requests for the feed to deliver on their arrival cycles.
+     *
+     * Must not be called while the simulation is running.
+     *
+     * @param batch Requests sorted by arrival cycle, none before the
+     *        arrivals already fed.
+     * @param n Number of requests.
+     */
+    void feedArrivals(const Request* batch, size_t n);
+
+    /**
+     * @brief Removes the oldest requests from the pool queues.
+     *
+     * @param out Receives the requests.
+     * @param max Room in out.
+     * @return Number of requests taken.
+     */
+    size_t takeQueued(Request* out, size_t max);
+
+    /**
+     * @brief Queues requests taken from another balancer.
+     *
+     * @param batch Requests to queue.
+     * @param n Number of requests.
+     */
+    void acceptQueued(const Request* batch, size_t n);
+
+    /**
+     * @brief Returns the number of requests waiting in every pool's queue.
+     *
+     * @return Total queue length.
+     */
+    size_t queueLength() const {
+        return queuedCount();
+    }
+
+    /**
+     * @brief Adds this run's queue waits and latencies to two histograms.
+     *
+     * @param wait Receives the queue waits of every started request.
+     * @param latency Receives the latencies of every completed request.
+     */
+    void mergeLatency(LatencyHistogram& wait, LatencyHistogram& latency) const;
 };
 
 #endif
@@ -0,0 +1,154 @@
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the live simulation metrics.
+ *
+ * This file implements the latency buckets, snapshots and the
+ * Prometheus and StatsD formats of Metrics.
+ */
+
+#include "Metrics.h"
+#include <sstream>
+
+const uint32_t Metrics::BUCKET_BOUNDS[MetricsSnapshot::BUCKETS - 1] = {
+    10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000
+};
+
+/**
+ * @brief Constructs metrics with every value zero.
+ */
+Metrics::Metrics()
+    : cycle(0),
+      queueDepth(0),
+      activeServers(0),
+      idleServers(0),
+      drainingServers(0),
+      processed(0),
+      blocked(0),
+      scaleUps(0),
+      scaleDowns(0),
+      latencyCount(0),
+      latencySum(0)
+{
+    for (std::atomic<uint64_t>& bucket : latencyBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Counts one completed request.
+ *
+ * @param latency Cycles from arrival to completion.
+ */
+void Metrics::recordLatency(uint32_t latency) {
+    size_t bucket = 0;
+    while (bucket < MetricsSnapshot::BUCKETS - 1 && latency > BUCKET_BOUNDS[bucket]) {
+        bucket++;
+    }
+    add(latencyBuckets[bucket], 1);
+    add(latencyCount, 1);
+    add(latencySum, latency);
+}
+
+/**
+ * @brief Copies every metric.
+ *
+ * @param out Receives the values.
+ */
+void Metrics::snapshot(MetricsSnapshot& out) const {
+    out.cycle = cycle.load(std::memory_order_relaxed);
+    out.queueDepth = queueDepth.load(std::memory_order_relaxed);
+    out.activeServers = activeServers.load(std::memory_order_relaxed);
+    out.idleServers = idleServers.load(std::memory_order_relaxed);
+    out.drainingServers = drainingServers.load(std::memory_order_relaxed);
+    out.processed = processed.load(std::memory_order_relaxed);
+    out.blocked = blocked.load(std::memory_order_relaxed);
+    out.scaleUps = scaleUps.load(std::memory_order_relaxed);
+    out.scaleDowns = scaleDowns.load(std::memory_order_relaxed);
+    out.latencyCount = latencyCount.load(std::memory_order_relaxed);
+    out.latencySum = latencySum.load(std::memory_order_relaxed);
+    for (size_t b = 0; b < MetricsSnapshot::BUCKETS; b++) {
+        out.latencyBuckets[b] = latencyBuckets[b].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes the HELP and TYPE comments of one Prometheus metric.
+ */
+static void describe(std::ostringstream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+}
+
+/**
+ * @brief Formats a snapshot in the Prometheus text exposition format.
+ *
+ * The latency buckets are reported cumulatively, as Prometheus
+ * histograms require.
+ *
+ * @param now Snapshot to format.
+ * @return One sample per line, with HELP and TYPE comments.
+ */
+std::string Metrics::formatPrometheus(const MetricsSnapshot& now) {
+    std::ostringstream out;
+    describe(out, "lb_cycle", "gauge", "Current simulated clock cycle.");
+    out << "lb_cycle " << now.cycle << '\n';
+    describe(out, "lb_queue_depth", "gauge", "Requests waiting for a server.");
+    out << "lb_queue_depth " << now.queueDepth << '\n';
+    describe(out, "lb_servers", "gauge", "Servers by state.");
+    out << "lb_servers{state=\"active\"} " << now.activeServers << '\n';
+    out << "lb_servers{state=\"idle\"} " << now.idleServers << '\n';
+    out << "lb_servers{state=\"draining\"} " << now.drainingServers << '\n';
+    describe(out, "lb_requests_processed", "gauge",
+             "Requests handed to servers, less those a draining server gave back.");
+    out << "lb_requests_processed " << now.processed << '\n';
+    describe(out, "lb_requests_blocked_total", "counter", "Requests from blocked addresses.");
+    out << "lb_requests_blocked_total " << now.blocked << '\n';
+    describe(out, "lb_scale_events_total", "counter", "Servers added or removed by autoscaling.");
+    out << "lb_scale_events_total{direction=\"up\"} " << now.scaleUps << '\n';
+    out << "lb_scale_events_total{direction=\"down\"} " << now.scaleDowns << '\n';
+
+    describe(out, "lb_request_latency_cycles", "histogram", "Cycles from arrival to completion.");
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b < MetricsSnapshot::BUCKETS - 1; b++) {
+        cumulative += now.latencyBuckets[b];
+        out << "lb_request_latency_cycles_bucket{le=\"" << BUCKET_BOUNDS[b] << "\"} " << cumulative << '\n';
+    }
+    out << "lb_request_latency_cycles_bucket{le=\"+Inf\"} " << now.latencyCount << '\n';
+    out << "lb_request_latency_cycles_sum " << now.latencySum << '\n';
+    out << "lb_request_latency_cycles_count " << now.latencyCount << '\n';
+    return out.str();
+}
+
+/**
+ * @brief Formats a snapshot as StatsD lines.
+ *
+ * The processed count is a gauge because a draining server hands its
+ * local queue back. Bucket counters are per bucket, not cumulative.
+ *
+ * @param now Snapshot to format.
+ * @param last Snapshot sent by the previous push.
+ * @return Newline-separated StatsD metrics.
+ */
+std::string Metrics::formatStatsd(const MetricsSnapshot& now, const MetricsSnapshot& last) {
+    std::ostringstream out;
+    out << "lb.cycle:" << now.cycle << "|g\n";
+    out << "lb.queue_depth:" << now.queueDepth << "|g\n";
+    out << "lb.servers.active:" << now.activeServers << "|g\n";
+    out << "lb.servers.idle:" << now.idleServers << "|g\n";
+    out << "lb.servers.draining:" << now.drainingServers << "|g\n";
+    out << "lb.requests.processed:" << now.processed << "|g\n";
+    out << "lb.requests.blocked:" << now.blocked - last.blocked << "|c\n";
+    out << "lb.scale.up:" << now.scaleUps - last.scaleUps << "|c\n";
+    out << "lb.scale.down:" << now.scaleDowns - last.scaleDowns << "|c\n";
+    out << "lb.latency.count:" << now.latencyCount - last.latencyCount << "|c\n";
+    out << "lb.latency.sum:" << now.latencySum - last.latencySum << "|c\n";
+    for (size_t b = 0; b < MetricsSnapshot::BUCKETS; b++) {
+        out << "lb.latency.bucket.";
+        if (b < MetricsSnapshot::BUCKETS - 1) {
+            out << "le_" << BUCKET_BOUNDS[b];
+        } else {
+            out << "inf";
+        }
+        out << ':' << now.latencyBuckets[b] - last.latencyBuckets[b] << "|c\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,147 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Plain copy of every metric at one moment.
+ */
+struct MetricsSnapshot {
+    /** Number of latency histogram buckets, the last one unbounded */
+    static constexpr size_t BUCKETS = 13;
+
+    uint64_t cycle = 0;
+    uint64_t queueDepth = 0;
+    uint64_t activeServers = 0;
+    uint64_t idleServers = 0;
+    uint64_t drainingServers = 0;
+    uint64_t processed = 0;
+    uint64_t blocked = 0;
+    uint64_t scaleUps = 0;
+    uint64_t scaleDowns = 0;
+    uint64_t latencyCount = 0;
+    uint64_t latencySum = 0;
+    uint64_t latencyBuckets[BUCKETS] = {};
+};
+
+/**
+ * @brief Live counters and gauges of one simulation.
+ *
+ * The simulation thread is the only writer. Every field is a relaxed
+ * atomic that it updates with a plain load and store, so publishing
+ * never waits on or contends with readers; a background exporter takes
+ * snapshots whenever it needs them. A snapshot is not atomic as a whole,
+ * but each field is a value the simulation really held.
+ *
+ * Request latencies, in cycles from arrival to completion, are counted
+ * in fixed buckets with upper bounds from 10 to 50000 cycles.
+ */
+class Metrics {
+private:
+    /** Upper bounds of every bucket but the last */
+    static const uint32_t BUCKET_BOUNDS[MetricsSnapshot::BUCKETS - 1];
+
+    alignas(64) std::atomic<uint64_t> cycle;
+    std::atomic<uint64_t> queueDepth;
+    std::atomic<uint64_t> activeServers;
+    std::atomic<uint64_t> idleServers;
+    std::atomic<uint64_t> drainingServers;
+    std::atomic<uint64_t> processed;
+    std::atomic<uint64_t> blocked;
+    std::atomic<uint64_t> scaleUps;
+    std::atomic<uint64_t> scaleDowns;
+    std::atomic<uint64_t> latencyCount;
+    std::atomic<uint64_t> latencySum;
+    std::atomic<uint64_t> latencyBuckets[MetricsSnapshot::BUCKETS];
+
+    /**
+     * @brief Adds to a field that only the simulation thread writes.
+     */
+    static void add(std::atomic<uint64_t>& field, uint64_t n) {
+        field.store(field.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets a field that only the simulation thread writes.
+     */
+    static void set(std::atomic<uint64_t>& field, uint64_t value) {
+        field.store(value, std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * @brief Constructs metrics with every value zero.
+     */
+    Metrics();
+
+    /**
+     * @brief Publishes the simulation's current state.
+     *
+     * @param cycleNow Current clock cycle
+     * @param queue Requests waiting in the pool queues
+     * @param active Servers accepting requests
+     * @param idle Active servers with a free lane
+     * @param draining Servers finishing their last requests
+     * @param processedTotal Requests handed to servers so far
+     * @param blockedTotal Requests blocked so far
+     */
+    void publish(int cycleNow, size_t queue, size_t active, size_t idle, size_t draining,
+                 int processedTotal, int blockedTotal) {
+        set(cycle, static_cast<uint64_t>(cycleNow));
+        set(queueDepth, queue);
+        set(activeServers, active);
+        set(idleServers, idle);
+        set(drainingServers, draining);
+        set(processed, static_cast<uint64_t>(processedTotal));
+        set(blocked, static_cast<uint64_t>(blockedTotal));
+    }
+
+    /**
+     * @brief Counts servers added or removed by one scaling decision.
+     *
+     * @param up true for servers added
+     * @param count Number of servers
+     */
+    void recordScale(bool up, int count) {
+        add(up ? scaleUps : scaleDowns, static_cast<uint64_t>(count));
+    }
+
+    /**
+     * @brief Counts one completed request.
+     *
+     * @param latency Cycles from arrival to completion
+     */
+    void recordLatency(uint32_t latency);
+
+    /**
+     * @brief Copies every metric.
+     *
+     * @param out Receives the values
+     */
+    void snapshot(MetricsSnapshot& out) const;
+
+    /**
+     * @brief Formats a snapshot in the Prometheus text exposition format.
+     *
+     * @param now Snapshot to format
+     * @return One sample per line, with HELP and TYPE comments
+     */
+    static std::string formatPrometheus(const MetricsSnapshot& now);
+
+    /**
+     * @brief Formats a snapshot as StatsD lines.
+     *
+     * Gauges carry their current value and counters the increase since
+     * the previous push.
+     *
+     * @param now Snapshot to format
+     * @param last Snapshot sent by the previous push
+     * @return Newline-separated StatsD metrics
+     */
+    static std::string formatStatsd(const MetricsSnapshot& now, const MetricsSnapshot& last);
+};
+
+#endif // METRICS_H
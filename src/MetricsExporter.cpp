@@ -0,0 +1,259 @@
+/**
+ * @file MetricsExporter.cpp
+ * @brief Implementation of the HTTP and StatsD metrics exporter.
+ *
+ * This file implements the exporter's sockets and its background loop,
+ * which polls the HTTP listener and pushes StatsD datagrams on schedule.
+ */
+
+#include "MetricsExporter.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/** Longest wait of the loop between checks for stop() */
+static const int POLL_MS = 100;
+
+/** Longest a scrape may take to send its request */
+static const int REQUEST_TIMEOUT_MS = 500;
+
+/**
+ * @brief Constructs an exporter with no endpoints.
+ *
+ * @param metrics Metrics to export.
+ */
+MetricsExporter::MetricsExporter(const Metrics& metrics)
+    : metrics(metrics),
+      stopping(false),
+      listenFd(-1),
+      statsdFd(-1),
+      pushIntervalMs(1000)
+{
+}
+
+/**
+ * @brief Stops the thread and closes every socket.
+ */
+MetricsExporter::~MetricsExporter() {
+    stop();
+    if (listenFd >= 0) {
+        ::close(listenFd);
+    }
+    if (statsdFd >= 0) {
+        ::close(statsdFd);
+    }
+}
+
+/**
+ * @brief Listens for Prometheus scrapes on a TCP port of every interface.
+ *
+ * @param port TCP port.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the port is open.
+ */
+bool MetricsExporter::listenHttp(int port, std::string& error) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        error = std::string("cannot create metrics socket: ") + std::strerror(errno);
+        return false;
+    }
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 16) < 0) {
+        error = "cannot listen for metrics on port " + std::to_string(port) + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    // A client that hangs up between poll() and accept() must not block the loop
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    listenFd = fd;
+    return true;
+}
+
+/**
+ * @brief Pushes StatsD metrics to host:port over UDP.
+ *
+ * @param target Destination as host:port.
+ * @param intervalMs Milliseconds between pushes.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the destination resolved.
+ */
+bool MetricsExporter::pushStatsd(const std::string& target, int intervalMs, std::string& error) {
+    size_t colon = target.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == target.size()) {
+        error = "statsd target '" + target + "' is not host:port";
+        return false;
+    }
+    std::string host = target.substr(0, colon);
+    std::string port = target.substr(colon + 1);
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    int status = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &found);
+    if (status != 0) {
+        error = "cannot resolve statsd target '" + target + "': " + ::gai_strerror(status);
+        return false;
+    }
+
+    int fd = -1;
+    for (addrinfo* candidate = found; candidate && fd < 0; candidate = candidate->ai_next) {
+        fd = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (fd >= 0 && ::connect(fd, candidate->ai_addr, candidate->ai_addrlen) < 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(found);
+    if (fd < 0) {
+        error = "cannot open a socket to statsd target '" + target + "'";
+        return false;
+    }
+    statsdFd = fd;
+    pushIntervalMs = std::max(intervalMs, 1);
+    return true;
+}
+
+/**
+ * @brief Starts the background thread if an endpoint is configured.
+ */
+void MetricsExporter::start() {
+    if (!worker.joinable() && (listenFd >= 0 || statsdFd >= 0)) {
+        stopping.store(false);
+        worker = std::thread(&MetricsExporter::run, this);
+    }
+}
+
+/**
+ * @brief Sends a last StatsD push and stops the background thread.
+ *
+ * The final push carries the run's closing values.
+ */
+void MetricsExporter::stop() {
+    if (worker.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        worker.join();
+        if (statsdFd >= 0) {
+            push();
+        }
+    }
+}
+
+/**
+ * @brief Serves scrapes and pushes until stop() is called.
+ */
+void MetricsExporter::run() {
+    using Clock = std::chrono::steady_clock;
+    const std::chrono::milliseconds interval(pushIntervalMs);
+    Clock::time_point nextPush = Clock::now() + interval;
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        int timeout = POLL_MS;
+        if (statsdFd >= 0) {
+            auto untilPush = std::chrono::duration_cast<std::chrono::milliseconds>(nextPush - Clock::now());
+            timeout = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(timeout, untilPush.count())));
+        }
+
+        if (listenFd >= 0) {
+            pollfd listener = {listenFd, POLLIN, 0};
+            if (::poll(&listener, 1, timeout) > 0 && (listener.revents & POLLIN)) {
+                int client = ::accept(listenFd, nullptr, nullptr);
+                if (client >= 0) {
+                    serve(client);
+                }
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+        }
+
+        if (statsdFd >= 0 && Clock::now() >= nextPush) {
+            push();
+            nextPush = std::max(nextPush + interval, Clock::now());
+        }
+    }
+}
+
+/**
+ * @brief Answers one HTTP connection and closes it.
+ *
+ * GET /metrics returns the Prometheus text format; any other request
+ * gets 404. Only the request line is looked at.
+ *
+ * @param fd Accepted socket.
+ */
+void MetricsExporter::serve(int fd) {
+    timeval timeout = {0, REQUEST_TIMEOUT_MS * 1000};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    char request[2048];
+    size_t length = 0;
+    while (length < sizeof(request) - 1) {
+        ssize_t n = ::recv(fd, request + length, sizeof(request) - 1 - length, 0);
+        if (n <= 0) {
+            break;
+        }
+        length += static_cast<size_t>(n);
+        request[length] = '\0';
+        if (std::strstr(request, "\r\n\r\n") || std::strstr(request, "\n\n")) {
+            break;
+        }
+    }
+    request[length] = '\0';
+
+    bool found = std::strncmp(request, "GET /metrics ", 13) == 0
+              || std::strncmp(request, "GET /metrics?", 13) == 0;
+    std::string body;
+    std::string status = "404 Not Found";
+    if (found) {
+        MetricsSnapshot now;
+        metrics.snapshot(now);
+        body = Metrics::formatPrometheus(now);
+        status = "200 OK";
+    }
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    ::close(fd);
+}
+
+/**
+ * @brief Sends the change since the previous push to the StatsD server.
+ *
+ * A failed send is dropped; the next push carries the accumulated change.
+ */
+void MetricsExporter::push() {
+    MetricsSnapshot now;
+    metrics.snapshot(now);
+    std::string datagram = Metrics::formatStatsd(now, lastPushed);
+    if (::send(statsdFd, datagram.data(), datagram.size(), 0) >= 0) {
+        lastPushed = now;
+    }
+}
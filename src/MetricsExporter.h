@@ -0,0 +1,96 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include "Metrics.h"
+
+/**
+ * @brief Background thread that makes a Metrics object visible outside
+ *        the process.
+ *
+ * The thread can serve the Prometheus text format to HTTP scrapes of
+ * /metrics, push StatsD lines over UDP at a fixed wall-clock interval,
+ * or both. It only ever reads the metrics, so the simulation never
+ * waits on a scrape, a slow client or the network.
+ */
+class MetricsExporter {
+private:
+    const Metrics& metrics;
+    std::thread worker;
+    std::atomic<bool> stopping;
+
+    int listenFd;
+    int statsdFd;
+    int pushIntervalMs;
+    MetricsSnapshot lastPushed;
+
+    /**
+     * @brief Serves scrapes and pushes until stop() is called.
+     */
+    void run();
+
+    /**
+     * @brief Answers one HTTP connection and closes it.
+     *
+     * @param fd Accepted socket
+     */
+    void serve(int fd);
+
+    /**
+     * @brief Sends the change since the previous push to the StatsD server.
+     */
+    void push();
+
+public:
+    /**
+     * @brief Constructs an exporter with no endpoints.
+     *
+     * @param metrics Metrics to export; must outlive the exporter
+     */
+    explicit MetricsExporter(const Metrics& metrics);
+
+    /**
+     * @brief Stops the thread and closes every socket.
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Listens for Prometheus scrapes on a TCP port of every interface.
+     *
+     * Must be called before start().
+     *
+     * @param port TCP port
+     * @param error Receives a description of the problem on failure
+     * @return true if the port is open
+     */
+    bool listenHttp(int port, std::string& error);
+
+    /**
+     * @brief Pushes StatsD metrics to host:port over UDP.
+     *
+     * Must be called before start().
+     *
+     * @param target Destination as host:port
+     * @param intervalMs Milliseconds between pushes
+     * @param error Receives a description of the problem on failure
+     * @return true if the destination resolved
+     */
+    bool pushStatsd(const std::string& target, int intervalMs, std::string& error);
+
+    /**
+     * @brief Starts the background thread if an endpoint is configured.
+     */
+    void start();
+
+    /**
+     * @brief Sends a last StatsD push and stops the background thread.
+     */
+    void stop();
+};
+
+#endif // METRICSEXPORTER_H
@@ -0,0 +1,154 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer queue.
+ *
+ * Each cell carries a sequence number that tells producers and
+ * consumers whether it is free or filled for their current lap around
+ * the ring (Vyukov's bounded MPMC design). A push or pop claims a
+ * position with one compare-and-swap and never takes a lock. The
+ * capacity is rounded up to a power of two.
+ *
+ * @tparam T Element type; must be trivially copyable
+ */
+template <typename T>
+class MpmcQueue {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MpmcQueue elements must be trivially copyable");
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    /** Next position producers will claim, on its own cache line */
+    alignas(64) std::atomic<size_t> enqueuePos;
+
+    /** Next position consumers will claim, on its own cache line */
+    alignas(64) std::atomic<size_t> dequeuePos;
+
+public:
+    /**
+     * @brief Constructs an empty queue.
+     *
+     * @param capacity Minimum number of elements the queue can hold
+     */
+    explicit MpmcQueue(size_t capacity)
+        : enqueuePos(0),
+          dequeuePos(0)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Appends an element if there is room. Safe from any thread.
+     *
+     * @param value Element to append
+     * @return true if queued, false if the queue is full
+     */
+    bool tryPush(const T& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                     std::memory_order_relaxed)) {
+                    cell.data = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element if there is one. Safe from any thread.
+     *
+     * @param value Receives the element
+     * @return true if an element was removed, false if the queue was empty
+     */
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                                     std::memory_order_relaxed)) {
+                    value = cell.data;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes up to max elements into out.
+     *
+     * @param out Destination array with room for max elements
+     * @param max Maximum number of elements to remove
+     * @return Number of elements removed
+     */
+    size_t tryPopBatch(T* out, size_t max) {
+        size_t n = 0;
+        while (n < max && tryPop(out[n])) {
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Checks whether the queue looked empty at the time of the call.
+     *
+     * @return true if no elements were queued
+     */
+    bool empty() const {
+        return enqueuePos.load(std::memory_order_acquire)
+            == dequeuePos.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the maximum number of queued elements.
+     *
+     * @return Capacity
+     */
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+#endif // MPMCQUEUE_H
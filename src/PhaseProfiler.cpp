@@ -0,0 +1,139 @@
+/**
+ * @file PhaseProfiler.cpp
+ * @brief Implementation of the run loop phase profiler.
+ *
+ * This file implements timer calibration, the per-phase breakdown and
+ * the Chrome trace writer.
+ */
+
+#include "PhaseProfiler.h"
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+/** Phase names, in Phase order */
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "other", "arrivals", "blocklist", "tick", "dispatch", "scaling", "logging"
+};
+
+/**
+ * @brief Constructs a profiler with every phase at zero.
+ */
+PhaseProfiler::PhaseProfiler()
+    : ticks(),
+      calls(),
+      depth(0),
+      tracing(false),
+      droppedEvents(0),
+      originTicks(now()),
+      originTime(std::chrono::steady_clock::now())
+{
+}
+
+/**
+ * @brief Returns nanoseconds per tick, measured since construction.
+ *
+ * @return Conversion factor.
+ */
+double PhaseProfiler::nanosPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t elapsedTicks = now() - originTicks;
+    double elapsedNanos = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - originTime).count();
+    return elapsedTicks > 0 ? elapsedNanos / elapsedTicks : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+/**
+ * @brief Keeps every phase entered as a trace event from now on.
+ */
+void PhaseProfiler::enableTrace() {
+    tracing = true;
+}
+
+/**
+ * @brief Returns the name of a phase.
+ *
+ * @param phase Phase.
+ * @return Lowercase name such as "dispatch".
+ */
+const char* PhaseProfiler::name(Phase phase) {
+    return PHASE_NAMES[static_cast<size_t>(phase)];
+}
+
+/**
+ * @brief Prints calls, total time, time per call and share of each phase.
+ *
+ * Phases that were never entered are left out.
+ *
+ * @param out Destination stream.
+ */
+void PhaseProfiler::writeBreakdown(std::ostream& out) const {
+    double scale = nanosPerTick();
+    uint64_t total = 0;
+    for (size_t p = 0; p < PHASE_COUNT; p++) {
+        total += ticks[p];
+    }
+
+    std::ostringstream table;
+    table << std::fixed;
+    table << "\nPhase         Calls    Total ms    ns/call   Share\n";
+    for (size_t p = 0; p < PHASE_COUNT; p++) {
+        if (calls[p] == 0) {
+            continue;
+        }
+        double nanos = ticks[p] * scale;
+        table << std::left << std::setw(10) << PHASE_NAMES[p] << std::right
+              << std::setw(9) << calls[p]
+              << std::setw(12) << std::setprecision(3) << nanos / 1e6
+              << std::setw(11) << std::setprecision(1) << nanos / calls[p]
+              << std::setw(7) << std::setprecision(1) << (total > 0 ? 100.0 * ticks[p] / total : 0.0)
+              << "%\n";
+    }
+    out << table.str();
+}
+
+/**
+ * @brief Writes the kept events in the Chrome trace event format.
+ *
+ * Every event is a complete ("X") event on one thread, with times in
+ * microseconds from the profiler's construction.
+ *
+ * @param path Output path.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the file was written.
+ */
+bool PhaseProfiler::writeChromeTrace(const std::string& path, std::string& error) const {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        error = "cannot create " + path;
+        return false;
+    }
+
+    double scale = nanosPerTick() / 1000.0;
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", out);
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& event = events[i];
+        std::fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                     i == 0 ? "" : ",\n", PHASE_NAMES[static_cast<size_t>(event.phase)],
+                     (event.start - originTicks) * scale, event.duration * scale);
+    }
+    std::fputs("\n]}\n", out);
+
+    if (std::fclose(out) != 0) {
+        error = "write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns how many events did not fit in the trace.
+ *
+ * @return Dropped event count.
+ */
+uint64_t PhaseProfiler::dropped() const {
+    return droppedEvents;
+}
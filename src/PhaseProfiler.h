@@ -0,0 +1,228 @@
+#ifndef PHASEPROFILER_H
+#define PHASEPROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Builds with LB_PHASE_TIMING=1 (make timing) time every phase of the
+ * simulation loop; other builds compile the timers away entirely.
+ */
+#ifndef LB_PHASE_TIMING
+#define LB_PHASE_TIMING 0
+#endif
+
+/** True when the phase timers are compiled in */
+constexpr bool PHASE_TIMING = LB_PHASE_TIMING != 0;
+
+/**
+ * @brief Parts of a simulated cycle that are timed separately.
+ */
+enum class Phase : uint8_t {
+    /** Loop overhead and anything not in another phase: ingress, metrics, checkpoints */
+    Other,
+    /** Drawing arrival counts and generating or replaying requests */
+    Arrivals,
+    /** Blocklist checks and queueing of the admitted requests */
+    Blocklist,
+    /** Ticking servers, or handling completion events in event-driven mode */
+    Tick,
+    /** Assigning queued requests to servers */
+    Dispatch,
+    /** Scaling decisions and adding or removing servers */
+    Scaling,
+    /** State lines and progress summaries */
+    Logging
+};
+
+/** Number of phases */
+static const size_t PHASE_COUNT = 7;
+
+/**
+ * @brief Accumulates the time spent in each phase of the run loop.
+ *
+ * Phases nest: entering one pauses the enclosing phase, so each is
+ * charged only its own time and the totals add up to the time spent
+ * inside the outermost phase. Time is read from the TSC where there is
+ * one and converted to nanoseconds with a rate measured against
+ * steady_clock over the whole run; elsewhere steady_clock is used
+ * directly.
+ *
+ * With tracing on, every phase entered is also kept as an event, up to
+ * MAX_TRACE_EVENTS, for writeChromeTrace().
+ */
+class PhaseProfiler {
+public:
+    /** Most events kept for the Chrome trace */
+    static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+private:
+    /**
+     * @brief One completed phase, for the trace.
+     */
+    struct TraceEvent {
+        uint64_t start;
+        uint64_t duration;
+        Phase phase;
+    };
+
+    /**
+     * @brief One phase on the stack of open ones.
+     */
+    struct Open {
+        Phase phase;
+        uint64_t entered;
+        uint64_t resumed;
+    };
+
+    uint64_t ticks[PHASE_COUNT];
+    uint64_t calls[PHASE_COUNT];
+    Open stack[PHASE_COUNT];
+    size_t depth;
+
+    bool tracing;
+    std::vector<TraceEvent> events;
+    uint64_t droppedEvents;
+
+    uint64_t originTicks;
+    std::chrono::steady_clock::time_point originTime;
+
+    /**
+     * @brief Returns nanoseconds per tick, measured since construction.
+     *
+     * @return Conversion factor
+     */
+    double nanosPerTick() const;
+
+public:
+    /**
+     * @brief Constructs a profiler with every phase at zero.
+     */
+    PhaseProfiler();
+
+    /**
+     * @brief Reads the timer.
+     *
+     * @return Current time in ticks
+     */
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Keeps every phase entered as a trace event from now on.
+     */
+    void enableTrace();
+
+    /**
+     * @brief Enters a phase, pausing the current one.
+     *
+     * @param phase Phase entered
+     */
+    void enter(Phase phase) {
+        uint64_t t = now();
+        if (depth > 0) {
+            Open& outer = stack[depth - 1];
+            ticks[static_cast<size_t>(outer.phase)] += t - outer.resumed;
+        }
+        stack[depth++] = Open{phase, t, t};
+    }
+
+    /**
+     * @brief Leaves the current phase, resuming the enclosing one.
+     */
+    void leave() {
+        uint64_t t = now();
+        const Open& open = stack[--depth];
+        size_t index = static_cast<size_t>(open.phase);
+        ticks[index] += t - open.resumed;
+        calls[index]++;
+        if (tracing) {
+            if (events.size() < MAX_TRACE_EVENTS) {
+                events.push_back(TraceEvent{open.entered, t - open.entered, open.phase});
+            } else {
+                droppedEvents++;
+            }
+        }
+        if (depth > 0) {
+            stack[depth - 1].resumed = t;
+        }
+    }
+
+    /**
+     * @brief Returns the name of a phase.
+     *
+     * @param phase Phase
+     * @return Lowercase name such as "dispatch"
+     */
+    static const char* name(Phase phase);
+
+    /**
+     * @brief Prints calls, total time, time per call and share of each phase.
+     *
+     * @param out Destination stream
+     */
+    void writeBreakdown(std::ostream& out) const;
+
+    /**
+     * @brief Writes the kept events in the Chrome trace event format.
+     *
+     * The file opens in chrome://tracing or Perfetto.
+     *
+     * @param path Output path
+     * @param error Receives a description of the problem on failure
+     * @return true if the file was written
+     */
+    bool writeChromeTrace(const std::string& path, std::string& error) const;
+
+    /**
+     * @brief Returns how many events did not fit in the trace.
+     *
+     * @return Dropped event count
+     */
+    uint64_t dropped() const;
+};
+
+/**
+ * @brief Times a phase for the lifetime of the scope.
+ *
+ * PhaseScope<false> does nothing, so call sites written as
+ * PhaseScope<PHASE_TIMING> cost nothing in builds without timing.
+ */
+template <bool Enabled>
+class PhaseScope {
+public:
+    PhaseScope(PhaseProfiler&, Phase) {}
+};
+
+template <>
+class PhaseScope<true> {
+private:
+    PhaseProfiler& profiler;
+
+public:
+    PhaseScope(PhaseProfiler& profiler, Phase phase) : profiler(profiler) {
+        profiler.enter(phase);
+    }
+
+    ~PhaseScope() {
+        profiler.leave();
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+};
+
+#endif // PHASEPROFILER_H
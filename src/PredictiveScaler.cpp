@@ -0,0 +1,154 @@
+/**
+ * @file PredictiveScaler.cpp
+ * @brief Implementation of the load-estimating autoscaler.
+ *
+ * This file implements the windowed arrival-rate and service-time
+ * estimates and the pool sizing rule of PredictiveScaler.
+ */
+
+#include "PredictiveScaler.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs a scaler from the autoscaling settings.
+ *
+ * @param config Simulation parameters.
+ * @param lanes Concurrent requests per server.
+ */
+PredictiveScaler::PredictiveScaler(const SimConfig& config, int lanes)
+    : interval(config.scaleInterval),
+      alpha(config.scaleAlpha),
+      hysteresis(config.scaleHysteresis),
+      targetWait(config.targetWait),
+      maxStep(config.scaleStep),
+      maxServers(config.maxServers),
+      lanes(lanes),
+      windowArrivals(0),
+      windowCompletions(0),
+      windowServiceSum(0),
+      arrivalRate(0),
+      serviceTime(((config.streamMin + config.streamMax) + (config.procMin + config.procMax)) / 4.0),
+      haveRate(false),
+      haveService(false)
+{
+}
+
+/**
+ * @brief Checks whether a scaling decision is due on a cycle.
+ *
+ * @param cycle Clock cycle.
+ * @return true at the end of every window.
+ */
+bool PredictiveScaler::isDecisionCycle(int cycle) const {
+    return cycle % interval == 0;
+}
+
+/**
+ * @brief Returns the first decision cycle after a given cycle.
+ *
+ * @param cycle Clock cycle.
+ * @return Next window boundary.
+ */
+int PredictiveScaler::nextDecisionCycle(int cycle) const {
+    return (cycle / interval + 1) * interval;
+}
+
+/**
+ * @brief Closes the current window and computes the desired pool size.
+ *
+ * The first window initializes each estimate directly; later windows
+ * blend in with weight alpha.
+ *
+ * @param servers Current number of servers.
+ * @param backlog Requests waiting in the request queue.
+ * @return Number of servers the pool should have.
+ */
+int PredictiveScaler::decide(int servers, size_t backlog) {
+    double rate = static_cast<double>(windowArrivals) / interval;
+    arrivalRate = haveRate ? arrivalRate + alpha * (rate - arrivalRate) : rate;
+    haveRate = true;
+
+    if (windowCompletions > 0) {
+        double mean = windowServiceSum / windowCompletions;
+        serviceTime = haveService ? serviceTime + alpha * (mean - serviceTime) : mean;
+        haveService = true;
+    }
+
+    windowArrivals = 0;
+    windowCompletions = 0;
+    windowServiceSum = 0;
+
+    double demand = (arrivalRate + static_cast<double>(backlog) / targetWait) * serviceTime / lanes;
+    int wanted = static_cast<int>(std::min(std::ceil(demand), 2147483647.0));
+    wanted = std::max(wanted, 1);
+    if (maxServers > 0) {
+        wanted = std::min(wanted, maxServers);
+    }
+
+    if (wanted < servers && wanted >= servers * (1.0 - hysteresis)) {
+        return servers;
+    }
+    if (maxStep > 0) {
+        wanted = std::max(servers - maxStep, std::min(servers + maxStep, wanted));
+    }
+    return wanted;
+}
+
+/**
+ * @brief Writes the estimates and the open window to a checkpoint.
+ *
+ * @param out Checkpoint being built.
+ */
+void PredictiveScaler::save(CheckpointWriter& out) const {
+    out.put<uint64_t>(windowArrivals);
+    out.put<uint64_t>(windowCompletions);
+    out.put(windowServiceSum);
+    out.put(arrivalRate);
+    out.put(serviceTime);
+    out.put<uint8_t>(haveRate);
+    out.put<uint8_t>(haveService);
+}
+
+/**
+ * @brief Restores estimates written by save().
+ *
+ * @param in Checkpoint being read.
+ * @return false if the checkpoint data is malformed.
+ */
+bool PredictiveScaler::load(CheckpointReader& in) {
+    uint64_t arrivals = 0;
+    uint64_t completions = 0;
+    uint8_t rate = 0;
+    uint8_t service = 0;
+    in.get(arrivals);
+    in.get(completions);
+    in.get(windowServiceSum);
+    in.get(arrivalRate);
+    in.get(serviceTime);
+    in.get(rate);
+    in.get(service);
+    windowArrivals = arrivals;
+    windowCompletions = completions;
+    haveRate = rate != 0;
+    haveService = service != 0;
+    return in.ok();
+}
+
+/**
+ * @brief Returns the smoothed arrival rate.
+ *
+ * @return Requests per cycle.
+ */
+double PredictiveScaler::getArrivalRate() const {
+    return arrivalRate;
+}
+
+/**
+ * @brief Returns the smoothed mean service time.
+ *
+ * @return Cycles per request.
+ */
+double PredictiveScaler::getServiceTime() const {
+    return serviceTime;
+}
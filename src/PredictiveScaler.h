@@ -0,0 +1,131 @@
+#ifndef PREDICTIVESCALER_H
+#define PREDICTIVESCALER_H
+
+#include <cstddef>
+#include "SimConfig.h"
+#include "CheckpointFile.h"
+
+/**
+ * @brief Sizes the server pool from measured load instead of queue ratios.
+ *
+ * Arrivals and completed processing times are accumulated over a fixed
+ * window of cycles. At the end of each window the arrival rate and mean
+ * service time are folded into exponentially weighted moving averages,
+ * and the pool size needed to serve the arrival rate while draining the
+ * current backlog within the target queue wait is
+ *
+ *     servers = ceil((arrivalRate + backlog / targetWait) * serviceTime / lanes)
+ *
+ * where lanes is the number of requests each server runs at once.
+ *
+ * The pool grows to that size at once but only shrinks once the target
+ * falls below the current size by more than the hysteresis fraction, so
+ * short lulls do not release servers that the next burst needs.
+ */
+class PredictiveScaler {
+private:
+    int interval;
+    double alpha;
+    double hysteresis;
+    int targetWait;
+    int maxStep;
+    int maxServers;
+    int lanes;
+
+    size_t windowArrivals;
+    size_t windowCompletions;
+    double windowServiceSum;
+
+    double arrivalRate;
+    double serviceTime;
+    bool haveRate;
+    bool haveService;
+
+public:
+    /**
+     * @brief Constructs a scaler from the autoscaling settings.
+     *
+     * Until the first completion, the service time estimate is the mean of
+     * the configured job time ranges.
+     *
+     * @param config Simulation parameters
+     * @param lanes Concurrent requests per server
+     */
+    explicit PredictiveScaler(const SimConfig& config, int lanes = 1);
+
+    /**
+     * @brief Counts requests accepted into the request queue.
+     *
+     * @param n Number of requests
+     */
+    void recordArrivals(size_t n) {
+        windowArrivals += n;
+    }
+
+    /**
+     * @brief Counts a request that finished processing.
+     *
+     * @param processingTime Processing time of the request in cycles
+     */
+    void recordCompletion(int processingTime) {
+        windowCompletions++;
+        windowServiceSum += processingTime;
+    }
+
+    /**
+     * @brief Checks whether a scaling decision is due on a cycle.
+     *
+     * @param cycle Clock cycle
+     * @return true at the end of every window
+     */
+    bool isDecisionCycle(int cycle) const;
+
+    /**
+     * @brief Returns the first decision cycle after a given cycle.
+     *
+     * @param cycle Clock cycle
+     * @return Next window boundary
+     */
+    int nextDecisionCycle(int cycle) const;
+
+    /**
+     * @brief Closes the current window and computes the desired pool size.
+     *
+     * @param servers Current number of servers
+     * @param backlog Requests waiting in the request queue
+     * @return Number of servers the pool should have; equal to servers
+     *         when no change is needed
+     */
+    int decide(int servers, size_t backlog);
+
+    /**
+     * @brief Writes the estimates and the open window to a checkpoint.
+     *
+     * @param out Checkpoint being built
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Restores estimates written by save().
+     *
+     * @param in Checkpoint being read
+     * @return false if the checkpoint data is malformed
+     */
+    bool load(CheckpointReader& in);
+
+    /**
+     * @brief Returns the smoothed arrival rate.
+     *
+     * @return Requests per cycle
+     */
+    double getArrivalRate() const;
+
+    /**
+     * @brief Returns the smoothed mean service time.
+     *
+     * @return Cycles per request
+     */
+    double getServiceTime() const;
+};
+
+#endif // PREDICTIVESCALER_H
@@ -0,0 +1,91 @@
+/**
+ * @file Random.cpp
+ * @brief Implementation of the xoshiro256** generator.
+ *
+ * This file implements seeding, stream jumping and state access for
+ * the simulation's random number generator.
+ */
+
+#include "Random.h"
+
+/**
+ * @brief Constructs a generator from a 64-bit seed.
+ *
+ * The seed is expanded into the 256-bit state with SplitMix64, which
+ * guarantees a non-zero state for every seed.
+ *
+ * @param seed Seed value.
+ */
+Random::Random(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * @brief Constructs the generator for one stream of a seed.
+ *
+ * @param seed Seed value.
+ * @param stream Stream index.
+ * @return Generator for that stream.
+ */
+Random Random::forStream(uint64_t seed, unsigned stream) {
+    Random rng(seed);
+    for (unsigned i = 0; i < stream; i++) {
+        rng.jump();
+    }
+    return rng;
+}
+
+/**
+ * @brief Advances the state by 2^128 draws.
+ *
+ * Uses the published xoshiro256 jump polynomial.
+ */
+void Random::jump() {
+    static const uint64_t JUMP[] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint64_t word : JUMP) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (word & (uint64_t(1) << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    s[i] ^= state[i];
+                }
+            }
+            next();
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        state[i] = s[i];
+    }
+}
+
+/**
+ * @brief Copies out the generator state.
+ *
+ * @param out Receives the four state words.
+ */
+void Random::getState(uint64_t out[4]) const {
+    for (int i = 0; i < 4; i++) {
+        out[i] = state[i];
+    }
+}
+
+/**
+ * @brief Restores a state previously returned by getState().
+ *
+ * @param in Four state words.
+ */
+void Random::setState(const uint64_t in[4]) {
+    for (int i = 0; i < 4; i++) {
+        state[i] = in[i];
+    }
+}
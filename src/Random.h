@@ -0,0 +1,111 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+/**
+ * @brief Fast, reproducible pseudo-random number generator.
+ *
+ * Implements xoshiro256** seeded through SplitMix64. Each instance owns
+ * its state, so separate simulations and threads never share a global
+ * generator the way std::rand() does. Independent streams for parallel
+ * use come from jump(), which advances the state by 2^128 draws.
+ */
+class Random {
+private:
+    uint64_t state[4];
+
+public:
+    /**
+     * @brief Constructs a generator from a 64-bit seed.
+     *
+     * @param seed Seed value; equal seeds produce equal sequences
+     */
+    explicit Random(uint64_t seed);
+
+    /**
+     * @brief Constructs the generator for one stream of a seed.
+     *
+     * Stream k is the seed's generator advanced by k jumps, so streams
+     * of the same seed never overlap in practice.
+     *
+     * @param seed Seed value
+     * @param stream Stream index, e.g. a thread or shard number
+     * @return Generator for that stream
+     */
+    static Random forStream(uint64_t seed, unsigned stream);
+
+    /**
+     * @brief Returns the next 64 random bits.
+     *
+     * @return Uniformly distributed 64-bit value
+     */
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Returns a uniformly distributed value in [0, bound).
+     *
+     * Uses Lemire's multiply-shift method with rejection, so there is no
+     * modulo bias.
+     *
+     * @param bound Exclusive upper bound, greater than zero
+     * @return Value in [0, bound)
+     */
+    uint32_t uniform(uint32_t bound) {
+        uint64_t product = (next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            uint32_t threshold = -bound % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    /**
+     * @brief Returns a uniformly distributed double in [0, 1).
+     *
+     * @return Value with 53 random bits of precision
+     */
+    double nextDouble() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @brief Advances the state by 2^128 draws.
+     */
+    void jump();
+
+    /**
+     * @brief Copies out the generator state.
+     *
+     * @param out Receives the four state words
+     */
+    void getState(uint64_t out[4]) const;
+
+    /**
+     * @brief Restores a state previously returned by getState().
+     *
+     * @param in Four state words
+     */
+    void setState(const uint64_t in[4]);
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif // RANDOM_H
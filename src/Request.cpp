@@ -26,20 +26,20 @@
  * a processing time measured in clock cycles, and a job type
  * (streaming or processing).
  *
- * @param ipIn Source IP address of the request.
- * @param ipOut Destination IP address of the request.
+ * @param ipIn Source IP address of the request (packed IPv4).
+ * @param ipOut Destination IP address of the request (packed IPv4).
  * @param isStreaming True if the request is a streaming job.
  * @param processingTime Number of clock cycles required to process the request.
  * @param arrivalTime Clock cycle when the request arrived.
  */
-Request::Request(const std::string& ipIn,
-                 const std::string& ipOut,
+Request::Request(uint32_t ipIn,
+                 uint32_t ipOut,
                  bool isStreaming,
                  int processingTime,
                  int arrivalTime)
     : ipIn(ipIn),
       ipOut(ipOut),
-      processingTime(processingTime),
+      processingTime(static_cast<uint32_t>(processingTime)),
       isStreaming(isStreaming),
       arrivalTime(arrivalTime)
 {
@@ -57,17 +57,89 @@ int Request::getProcessingTime() const {
 /**
  * @brief Gets the source IP address of the request.
  *
- * @return Source IP address as a string.
+ * @return Source IP address as a packed IPv4 value.
  */
-std::string Request::getIpIn() const {
+uint32_t Request::getIpIn() const {
     return ipIn;
 }
 
 /**
  * @brief Gets the destination IP address of the request.
  *
- * @return Destination IP address as a string.
+ * @return Destination IP address as a packed IPv4 value.
  */
-std::string Request::getIpOut() const {
+uint32_t Request::getIpOut() const {
     return ipOut;
 }
+
+/**
+ * @brief Gets the clock cycle at which the request arrived.
+ *
+ * @return Arrival cycle.
+ */
+int Request::getArrivalTime() const {
+    return arrivalTime;
+}
+
+/**
+ * @brief Checks whether the request is a streaming job.
+ *
+ * @return true for streaming jobs, false for processing jobs.
+ */
+bool Request::isStreamingJob() const {
+    return isStreaming != 0;
+}
+
+/**
+ * @brief Formats a packed IPv4 address in dotted-quad notation.
+ *
+ * @param ip Packed IPv4 address.
+ * @return Address in the format "x.x.x.x".
+ */
+std::string ipToString(uint32_t ip) {
+    return std::to_string(ip >> 24) + "." +
+           std::to_string((ip >> 16) & 0xFF) + "." +
+           std::to_string((ip >> 8) & 0xFF) + "." +
+           std::to_string(ip & 0xFF);
+}
+
+/**
+ * @brief Parses a dotted-quad IPv4 address.
+ *
+ * Each of the four octets must be a decimal number from 0 to 255.
+ *
+ * @param text Address in the format "x.x.x.x".
+ * @param ip Receives the packed address on success.
+ * @return true if the text is a valid IPv4 address.
+ */
+bool parseIP(const std::string& text, uint32_t& ip) {
+    uint32_t result = 0;
+    size_t pos = 0;
+
+    for (int octet = 0; octet < 4; octet++) {
+        if (octet > 0) {
+            if (pos >= text.size() || text[pos] != '.') {
+                return false;
+            }
+            pos++;
+        }
+
+        size_t start = pos;
+        uint32_t value = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9'
+               && pos - start < 3) {
+            value = value * 10 + (text[pos] - '0');
+            pos++;
+        }
+        if (pos == start || value > 255) {
+            return false;
+        }
+        result = (result << 8) | value;
+    }
+
+    if (pos != text.size()) {
+        return false;
+    }
+    ip = result;
+    return true;
+}
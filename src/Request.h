@@ -1,7 +1,9 @@
 #ifndef REQUEST_H
 #define REQUEST_H
 
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 /**
  * @brief Represents a single request handled by the load balancer.
@@ -9,27 +11,38 @@
  * A request contains source and destination IP addresses,
  * a processing time measured in clock cycles, and a job type
  * indicating whether the request is streaming or processing.
+ *
+ * Addresses are stored as packed 32-bit IPv4 values (first octet in
+ * the most significant byte), so a Request is a trivially copyable
+ * 16-byte value. Use ipToString() to format an address for logging.
  */
 class Request {
 private:
-    std::string ipIn;
-    std::string ipOut;
-    int processingTime;
-    bool isStreaming;
+    uint32_t ipIn;
+    uint32_t ipOut;
+    uint32_t processingTime : 31;
+    uint32_t isStreaming : 1;
     int arrivalTime;
 
 public:
+    /**
+     * @brief Constructs an empty placeholder request.
+     *
+     * Allows Requests to be stored in preallocated arrays.
+     */
+    Request() = default;
+
     /**
      * @brief Constructs a Request object.
      *
-     * @param ipIn Source IP address
-     * @param ipOut Destination IP address
+     * @param ipIn Source IP address (packed IPv4)
+     * @param ipOut Destination IP address (packed IPv4)
      * @param processingTime Time required to process the request (clock cycles)
      * @param isStreaming True if type of request is streaming
      * @param arrivalTime Clock cycle when request was created
      */
-    Request(const std::string& ipIn,
-            const std::string& ipOut,
+    Request(uint32_t ipIn,
+            uint32_t ipOut,
             bool isStreaming,
             int processingTime,
             int arrivalTime);
@@ -44,17 +57,51 @@ public:
     /**
      * @brief Gets the source IP address of the request.
      *
-     * @return Source IP address as a string.
+     * @return Source IP address as a packed IPv4 value.
      */
-    std::string getIpIn() const;
+    uint32_t getIpIn() const;
 
     /**
      * @brief Gets the destination IP address of the request.
      *
-     * @return Destination IP address as a string.
+     * @return Destination IP address as a packed IPv4 value.
      */
-    std::string getIpOut() const;
+    uint32_t getIpOut() const;
 
+    /**
+     * @brief Gets the clock cycle at which the request arrived.
+     *
+     * @return Arrival cycle.
+     */
+    int getArrivalTime() const;
+
+    /**
+     * @brief Checks whether the request is a streaming job.
+     *
+     * @return true for streaming jobs, false for processing jobs.
+     */
+    bool isStreamingJob() const;
 };
 
+static_assert(std::is_trivially_copyable<Request>::value,
+              "Request must stay trivially copyable");
+static_assert(sizeof(Request) == 16, "Request should pack into 16 bytes");
+
+/**
+ * @brief Formats a packed IPv4 address in dotted-quad notation.
+ *
+ * @param ip Packed IPv4 address
+ * @return Address in the format "x.x.x.x"
+ */
+std::string ipToString(uint32_t ip);
+
+/**
+ * @brief Parses a dotted-quad IPv4 address.
+ *
+ * @param text Address in the format "x.x.x.x"
+ * @param ip Receives the packed address on success
+ * @return true if the text is a valid IPv4 address
+ */
+bool parseIP(const std::string& text, uint32_t& ip);
+
 #endif // REQUEST_H
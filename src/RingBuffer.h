@@ -0,0 +1,219 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Growable FIFO queue backed by a power-of-two ring buffer.
+ *
+ * Elements live in one contiguous array that doubles when full, so the
+ * queue has no per-chunk allocations and indexes with a mask instead of
+ * a modulo. Batch push/pop move whole runs of elements with at most two
+ * memcpy calls, and frontRun()/drop() let a consumer read elements in
+ * place instead of copying them out. The element type must be
+ * trivially copyable.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class RingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RingBuffer elements must be trivially copyable");
+
+private:
+    std::unique_ptr<T[]> buffer;
+    size_t cap;
+    size_t head;
+    size_t count;
+
+    /**
+     * @brief Reallocates to at least the given capacity, unwrapping the
+     *        contents to the start of the new array.
+     */
+    void grow(size_t minCapacity) {
+        size_t capacity = cap == 0 ? 16 : cap;
+        while (capacity < minCapacity) {
+            capacity *= 2;
+        }
+        // Left uninitialized: T is trivially copyable and slots are
+        // written before they are read
+        std::unique_ptr<T[]> next(new T[capacity]);
+        copyOut(next.get(), count);
+        buffer.swap(next);
+        cap = capacity;
+        head = 0;
+    }
+
+    /** Copies the first n queued elements to out without removing them */
+    void copyOut(T* out, size_t n) const {
+        if (n == 0) {
+            return;
+        }
+        size_t first = std::min(n, cap - head);
+        std::memcpy(out, buffer.get() + head, first * sizeof(T));
+        std::memcpy(out + first, buffer.get(), (n - first) * sizeof(T));
+    }
+
+public:
+    /**
+     * @brief Constructs an empty queue with no storage.
+     */
+    RingBuffer() : cap(0), head(0), count(0) {}
+
+    /**
+     * @brief Ensures room for at least n elements without reallocating.
+     *
+     * @param n Number of elements
+     */
+    void reserve(size_t n) {
+        if (n > cap) {
+            grow(n);
+        }
+    }
+
+    /**
+     * @brief Appends an element at the back.
+     *
+     * @param value Element to append
+     */
+    void push(const T& value) {
+        if (count == cap) {
+            grow(count + 1);
+        }
+        buffer[(head + count) & (cap - 1)] = value;
+        count++;
+    }
+
+    /**
+     * @brief Appends n elements at the back in order.
+     *
+     * @param values Elements to append
+     * @param n Number of elements
+     */
+    void pushBatch(const T* values, size_t n) {
+        if (count + n > cap) {
+            grow(count + n);
+        }
+        size_t tail = (head + count) & (cap - 1);
+        size_t first = std::min(n, cap - tail);
+        std::memcpy(buffer.get() + tail, values, first * sizeof(T));
+        std::memcpy(buffer.get(), values + first, (n - first) * sizeof(T));
+        count += n;
+    }
+
+    /**
+     * @brief Returns the element at the front. The queue must not be empty.
+     *
+     * @return Reference to the oldest element
+     */
+    const T& front() const {
+        return buffer[head];
+    }
+
+    /**
+     * @brief Removes the element at the front. The queue must not be empty.
+     */
+    void pop() {
+        head = (head + 1) & (cap - 1);
+        count--;
+    }
+
+    /**
+     * @brief Returns the front elements that are contiguous in storage,
+     *        leaving them queued.
+     *
+     * The run stops at the end of the array, so a wrapped queue takes
+     * two calls. The pointer is valid until the queue next grows.
+     *
+     * @param run Receives a pointer to the oldest element
+     * @param max Maximum number of elements in the run
+     * @return Number of elements in the run
+     */
+    size_t frontRun(const T*& run, size_t max) const {
+        run = buffer.get() + head;
+        return std::min(std::min(max, count), cap - head);
+    }
+
+    /**
+     * @brief Removes n elements from the front without reading them.
+     *
+     * @param n Number of elements; at most size()
+     */
+    void drop(size_t n) {
+        if (n > 0) {
+            head = (head + n) & (cap - 1);
+            count -= n;
+        }
+    }
+
+    /**
+     * @brief Removes up to max elements from the front into out.
+     *
+     * @param out Destination array with room for max elements
+     * @param max Maximum number of elements to remove
+     * @return Number of elements removed
+     */
+    size_t popBatch(T* out, size_t max) {
+        size_t n = std::min(max, count);
+        copyOut(out, n);
+        if (n > 0) {
+            head = (head + n) & (cap - 1);
+            count -= n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Copies up to max elements from the front without removing them.
+     *
+     * @param out Destination array with room for max elements
+     * @param max Maximum number of elements to copy
+     * @return Number of elements copied
+     */
+    size_t peekBatch(T* out, size_t max) const {
+        size_t n = std::min(max, count);
+        copyOut(out, n);
+        return n;
+    }
+
+    /**
+     * @brief Removes every element, keeping the storage.
+     */
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Returns the number of queued elements.
+     *
+     * @return Element count
+     */
+    size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Checks whether the queue is empty.
+     *
+     * @return true if no elements are queued
+     */
+    bool empty() const {
+        return count == 0;
+    }
+
+    /**
+     * @brief Returns the number of elements that fit without growing.
+     *
+     * @return Current capacity
+     */
+    size_t capacity() const {
+        return cap;
+    }
+};
+
+#endif // RINGBUFFER_H
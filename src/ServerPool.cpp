@@ -0,0 +1,245 @@
+/**
+ * @file ServerPool.cpp
+ * @brief Implementation of the structure-of-arrays server pool.
+ *
+ * This file implements growing the pool and the vectorized tick
+ * kernel that advances every busy lane and collects the ones that
+ * finished into a bitmask.
+ */
+
+#include "ServerPool.h"
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Ticks one block of 64 lanes.
+ *
+ * Busy lanes (remaining > 0) are decremented by adding the all-ones
+ * comparison mask; lanes that were busy and are now zero become bits of
+ * the result.
+ *
+ * @param remaining First of 64 remaining times.
+ * @return Bitmask of lanes that finished.
+ */
+static uint64_t tickBlock(int32_t* remaining) {
+    uint64_t finished = 0;
+
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    for (int lane = 0; lane < 64; lane += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(remaining + lane);
+        __m256i value = _mm256_loadu_si256(p);
+        __m256i busy = _mm256_cmpgt_epi32(value, zero);
+        value = _mm256_add_epi32(value, busy);
+        _mm256_storeu_si256(p, value);
+        __m256i done = _mm256_and_si256(busy, _mm256_cmpeq_epi32(value, zero));
+        uint64_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(done)));
+        finished |= bits << lane;
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (int lane = 0; lane < 64; lane += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(remaining + lane);
+        __m128i value = _mm_loadu_si128(p);
+        __m128i busy = _mm_cmpgt_epi32(value, zero);
+        value = _mm_add_epi32(value, busy);
+        _mm_storeu_si128(p, value);
+        __m128i done = _mm_and_si128(busy, _mm_cmpeq_epi32(value, zero));
+        uint64_t bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(done)));
+        finished |= bits << lane;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const int32x4_t zero = vdupq_n_s32(0);
+    const uint32_t weightsArray[4] = {1, 2, 4, 8};
+    const uint32x4_t laneBits = vld1q_u32(weightsArray);
+    for (int lane = 0; lane < 64; lane += 4) {
+        int32x4_t value = vld1q_s32(remaining + lane);
+        uint32x4_t busy = vcgtq_s32(value, zero);
+        value = vaddq_s32(value, vreinterpretq_s32_u32(busy));
+        vst1q_s32(remaining + lane, value);
+        uint32x4_t done = vandq_u32(busy, vceqq_s32(value, zero));
+        uint64_t bits = vaddvq_u32(vandq_u32(done, laneBits));
+        finished |= bits << lane;
+    }
+#else
+    for (int lane = 0; lane < 64; lane++) {
+        int32_t busy = remaining[lane] > 0;
+        remaining[lane] -= busy;
+        finished |= static_cast<uint64_t>(busy & (remaining[lane] == 0)) << lane;
+    }
+#endif
+
+    return finished;
+}
+
+/**
+ * @brief Constructs an empty pool.
+ *
+ * @param queueCapacity Requests each server may queue behind its running ones.
+ */
+ServerPool::ServerPool(size_t queueCapacity)
+    : firstLane(1, 0),
+      queueCapacity(queueCapacity),
+      count(0)
+{
+}
+
+/**
+ * @brief Appends an idle server.
+ *
+ * The remaining-time array grows a whole block at a time; the queue
+ * slab grows by the new server's ring.
+ *
+ * @param weight Relative capacity used by weighted dispatch.
+ * @param speed Work units completed per cycle.
+ * @param lanes Number of requests the server runs at once.
+ * @return Slot of the new server.
+ */
+size_t ServerPool::add(double weight, double speed, size_t lanes) {
+    size_t end = firstLane.back() + lanes;
+    if (end > remaining.size()) {
+        remaining.resize((end + BLOCK - 1) / BLOCK * BLOCK, 0);
+    }
+    current.resize(end, Request(0, 0, false, 0, 0));
+    laneServer.resize(end, static_cast<uint32_t>(count));
+    firstLane.push_back(end);
+    weights.push_back(weight);
+    speeds.push_back(speed);
+    waiting.resize(waiting.size() + queueCapacity, Request(0, 0, false, 0, 0));
+    queueHead.push_back(0);
+    queueSize.push_back(0);
+    return count++;
+}
+
+/**
+ * @brief Returns the number of server slots.
+ *
+ * @return Pool size.
+ */
+size_t ServerPool::size() const {
+    return count;
+}
+
+/**
+ * @brief Returns the number of lanes over every server.
+ *
+ * @return Lane count, excluding padding.
+ */
+size_t ServerPool::laneCount() const {
+    return firstLane.back();
+}
+
+/**
+ * @brief Returns the number of 64-lane blocks covering the pool.
+ *
+ * @return Words needed for a finished bitmask.
+ */
+size_t ServerPool::blocks() const {
+    return remaining.size() / BLOCK;
+}
+
+/**
+ * @brief Returns a handle to one server.
+ *
+ * @param index Slot of the server.
+ * @return Handle referring to this pool.
+ */
+WebServer ServerPool::operator[](size_t index) {
+    return WebServer(*this, index);
+}
+
+/**
+ * @brief Writes every slot's state to a checkpoint.
+ *
+ * @param out Checkpoint being built.
+ */
+void ServerPool::save(CheckpointWriter& out) const {
+    out.putArray(firstLane.data(), firstLane.size());
+    out.putArray(remaining.data(), laneCount());
+    out.putArray(current.data(), laneCount());
+    out.putArray(weights.data(), count);
+    out.putArray(speeds.data(), count);
+
+    std::vector<Request> queued;
+    for (size_t i = 0; i < count; i++) {
+        queued.resize(queueSize[i]);
+        for (size_t q = 0; q < queued.size(); q++) {
+            queued[q] = waiting[i * queueCapacity + (queueHead[i] + q) % queueCapacity];
+        }
+        out.putArray(queued.data(), queued.size());
+    }
+}
+
+/**
+ * @brief Replaces the whole pool with one read from a checkpoint.
+ *
+ * The pool keeps its own queue capacity.
+ *
+ * @param in Checkpoint being read.
+ * @return false if the checkpoint data is malformed or a local queue
+ *         holds more requests than the capacity.
+ */
+bool ServerPool::load(CheckpointReader& in) {
+    std::vector<size_t> lanes;
+    std::vector<int32_t> times;
+    std::vector<Request> requests;
+    std::vector<double> slotWeights;
+    std::vector<double> slotSpeeds;
+    if (!in.getArray(lanes) || !in.getArray(times) || !in.getArray(requests)
+        || !in.getArray(slotWeights) || !in.getArray(slotSpeeds) || lanes.empty() || lanes[0] != 0) {
+        return false;
+    }
+    size_t slots = lanes.size() - 1;
+    for (size_t i = 0; i < slots; i++) {
+        if (lanes[i + 1] <= lanes[i]) {
+            return false;
+        }
+    }
+    if (times.size() != lanes.back() || requests.size() != lanes.back()
+        || slotWeights.size() != slots || slotSpeeds.size() != slots) {
+        return false;
+    }
+
+    remaining.assign((times.size() + BLOCK - 1) / BLOCK * BLOCK, 0);
+    std::copy(times.begin(), times.end(), remaining.begin());
+    current = requests;
+    firstLane = lanes;
+    laneServer.clear();
+    for (size_t i = 0; i < slots; i++) {
+        laneServer.resize(lanes[i + 1], static_cast<uint32_t>(i));
+    }
+    weights = slotWeights;
+    speeds = slotSpeeds;
+    waiting.assign(slots * queueCapacity, Request(0, 0, false, 0, 0));
+    queueHead.assign(slots, 0);
+    queueSize.assign(slots, 0);
+    count = slots;
+
+    std::vector<Request> queued;
+    for (size_t i = 0; i < count; i++) {
+        if (!in.getArray(queued) || queued.size() > queueCapacity) {
+            return false;
+        }
+        std::copy(queued.begin(), queued.end(), waiting.begin() + i * queueCapacity);
+        queueSize[i] = static_cast<uint32_t>(queued.size());
+    }
+    return true;
+}
+
+/**
+ * @brief Advances a range of blocks by one clock cycle.
+ *
+ * @param firstBlock First block to tick.
+ * @param endBlock One past the last block to tick.
+ * @param finished Bitmask with one word per block.
+ */
+void ServerPool::tick(size_t firstBlock, size_t endBlock, uint64_t* finished) {
+    for (size_t block = firstBlock; block < endBlock; block++) {
+        finished[block] = tickBlock(remaining.data() + block * BLOCK);
+    }
+}
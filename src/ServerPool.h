@@ -0,0 +1,177 @@
+#ifndef SERVERPOOL_H
+#define SERVERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Request.h"
+#include "RingBuffer.h"
+#include "WebServer.h"
+#include "CheckpointFile.h"
+
+/**
+ * @brief Structure-of-arrays storage for every web server.
+ *
+ * Each server's state is split across parallel arrays indexed by slot,
+ * so the per-cycle tick walks one dense array of remaining times instead
+ * of whole server objects. A server runs up to a fixed number of
+ * requests at once, one per lane; its lanes are consecutive entries of
+ * the per-lane arrays. A lane is busy exactly when its remaining time
+ * is positive (every job takes at least one cycle).
+ *
+ * tick() processes lanes in blocks of 64 and reports the ones that
+ * finished as one bit per lane. The kernel uses AVX2, SSE2 or NEON
+ * when the compiler targets them and plain C++ otherwise; all variants
+ * give identical results. The remaining-time array is padded with idle
+ * lanes to a whole number of blocks.
+ */
+class ServerPool {
+private:
+    friend class WebServer;
+
+    /** Remaining processing time per lane, padded to a multiple of BLOCK */
+    std::vector<int32_t> remaining;
+
+    /** Request running (or last run) on each lane */
+    std::vector<Request> current;
+
+    /** Server owning each lane */
+    std::vector<uint32_t> laneServer;
+
+    /** First lane of each slot, followed by the total lane count */
+    std::vector<size_t> firstLane;
+
+    /** Relative capacity of each slot */
+    std::vector<double> weights;
+
+    /** Work units each slot completes per cycle */
+    std::vector<double> speeds;
+
+    /**
+     * Requests waiting behind the running ones. Every slot owns a fixed
+     * ring of queueCapacity entries in this one slab, so local queues
+     * never allocate once the pool has grown.
+     */
+    std::vector<Request> waiting;
+
+    /** Position of each slot's oldest waiting request within its ring */
+    std::vector<uint32_t> queueHead;
+
+    /** Number of requests waiting on each slot */
+    std::vector<uint32_t> queueSize;
+
+    size_t queueCapacity;
+    size_t count;
+
+public:
+    /** Lanes covered by one word of the finished bitmask */
+    static constexpr size_t BLOCK = 64;
+
+    /**
+     * @brief Constructs an empty pool.
+     *
+     * @param queueCapacity Requests each server may queue behind its
+     *        running ones
+     */
+    explicit ServerPool(size_t queueCapacity = 0);
+
+    /**
+     * @brief Appends an idle server.
+     *
+     * @param weight Relative capacity used by weighted dispatch
+     * @param speed Work units completed per cycle
+     * @param lanes Number of requests the server runs at once
+     * @return Slot of the new server
+     */
+    size_t add(double weight, double speed = 1.0, size_t lanes = 1);
+
+    /**
+     * @brief Returns the number of server slots.
+     *
+     * @return Pool size
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of lanes over every server.
+     *
+     * @return Lane count, excluding padding
+     */
+    size_t laneCount() const;
+
+    /**
+     * @brief Returns the server a lane belongs to.
+     *
+     * @param lane Lane index
+     * @return Slot of the owning server
+     */
+    size_t serverOfLane(size_t lane) const {
+        return laneServer[lane];
+    }
+
+    /**
+     * @brief Checks whether a lane is running a request.
+     *
+     * @param lane Lane index
+     * @return true if the lane's remaining time is positive
+     */
+    bool isLaneBusy(size_t lane) const {
+        return remaining[lane] > 0;
+    }
+
+    /**
+     * @brief Keeps a lane that tick() just finished busy until its
+     *        completion is handled.
+     *
+     * @param lane Lane index
+     */
+    void holdLane(size_t lane) {
+        remaining[lane] = 1;
+    }
+
+    /**
+     * @brief Returns the number of 64-lane blocks covering the pool.
+     *
+     * @return Words needed for a finished bitmask
+     */
+    size_t blocks() const;
+
+    /**
+     * @brief Returns a handle to one server.
+     *
+     * @param index Slot of the server
+     * @return Handle referring to this pool
+     */
+    WebServer operator[](size_t index);
+
+    /**
+     * @brief Writes every slot's state to a checkpoint.
+     *
+     * @param out Checkpoint being built
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Replaces the whole pool with one read from a checkpoint.
+     *
+     * @param in Checkpoint being read
+     * @return false if the checkpoint data is malformed
+     */
+    bool load(CheckpointReader& in);
+
+    /**
+     * @brief Advances a range of blocks by one clock cycle.
+     *
+     * Every busy lane in the range loses one cycle of remaining time.
+     * Bit j of finished[b] is set if lane b * 64 + j reached zero on
+     * this cycle; words outside the range are not touched, so threads
+     * may tick disjoint ranges of the same pool concurrently.
+     *
+     * @param firstBlock First block to tick
+     * @param endBlock One past the last block to tick
+     * @param finished Bitmask with one word per block
+     */
+    void tick(size_t firstBlock, size_t endBlock, uint64_t* finished);
+};
+
+#endif // SERVERPOOL_H
@@ -0,0 +1,124 @@
+/**
+ * @file ShardPool.cpp
+ * @brief Implementation of the multi-threaded server tick.
+ *
+ * This file implements splitting the web server pool into shards of
+ * whole blocks and advancing them in parallel with a barrier at the end
+ * of each cycle.
+ */
+
+#include "ShardPool.h"
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * A pool of N shards starts N - 1 threads; the thread calling tick()
+ * handles shard 0 itself.
+ *
+ * @param numShards Number of shards, including the calling thread's.
+ */
+ShardPool::ShardPool(int numShards)
+    : numShards(numShards < 1 ? 1 : numShards),
+      generation(0),
+      pending(0),
+      stopping(false),
+      servers(nullptr),
+      finishedBits(nullptr)
+{
+    for (int shard = 1; shard < size(); shard++) {
+        workers.emplace_back(&ShardPool::workerLoop, this, shard);
+    }
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ */
+ShardPool::~ShardPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCycle.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Ticks the blocks of one shard.
+ *
+ * Shard boundaries follow the current pool size, so they adjust
+ * automatically as servers are added between cycles.
+ *
+ * @param shard Shard index.
+ */
+void ShardPool::tickShard(int shard) {
+    size_t blocks = servers->blocks();
+    size_t begin = blocks * shard / size();
+    size_t end = blocks * (shard + 1) / size();
+    servers->tick(begin, end, finishedBits);
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ *
+ * Waits for the next cycle, ticks its shard and reports back.
+ *
+ * @param shard Shard owned by this worker.
+ */
+void ShardPool::workerLoop(int shard) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCycle.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        tickShard(shard);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            cycleDone.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Advances every server by one clock cycle.
+ *
+ * Releases the workers, ticks shard 0 on the calling thread and waits
+ * for the rest.
+ *
+ * @param pool Servers to tick.
+ * @param finished Resized to one word per block and filled with a bit
+ *        for every server that became idle this cycle.
+ */
+void ShardPool::tick(ServerPool& pool, std::vector<uint64_t>& finished) {
+    finished.resize(pool.blocks());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        servers = &pool;
+        finishedBits = finished.data();
+        pending = size() - 1;
+        generation++;
+    }
+    startCycle.notify_all();
+
+    tickShard(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cycleDone.wait(lock, [this] { return pending == 0; });
+}
+
+/**
+ * @brief Returns the number of shards.
+ *
+ * @return Shard count.
+ */
+int ShardPool::size() const {
+    return numShards;
+}
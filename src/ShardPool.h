@@ -0,0 +1,96 @@
+#ifndef SHARDPOOL_H
+#define SHARDPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ServerPool.h"
+
+/**
+ * @brief Advances the server pool one clock cycle on several threads.
+ *
+ * The pool is split into contiguous shards of whole 64-server blocks,
+ * one per thread. The calling thread works on the first shard and each
+ * worker thread owns one of the rest. tick() acts as a per-cycle
+ * barrier: it returns only after every shard has run the pool's tick
+ * kernel over its blocks. Each shard writes its own words of the shared
+ * finished bitmask, so no merge step is needed.
+ */
+class ShardPool {
+private:
+    std::vector<std::thread> workers;
+
+    /** Number of shards, including the calling thread's */
+    int numShards;
+
+    std::mutex mutex;
+    std::condition_variable startCycle;
+    std::condition_variable cycleDone;
+
+    /** Incremented each cycle to release the workers */
+    uint64_t generation;
+
+    /** Number of worker shards still running the current cycle */
+    int pending;
+
+    bool stopping;
+
+    /** Server pool being ticked during the current cycle */
+    ServerPool* servers;
+
+    /** Finished bitmask being filled during the current cycle */
+    uint64_t* finishedBits;
+
+    /**
+     * @brief Ticks the blocks of one shard.
+     *
+     * @param shard Shard index
+     */
+    void tickShard(int shard);
+
+    /**
+     * @brief Main loop of a worker thread.
+     *
+     * @param shard Shard owned by this worker
+     */
+    void workerLoop(int shard);
+
+public:
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param numShards Number of shards, including the calling thread's
+     */
+    explicit ShardPool(int numShards);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~ShardPool();
+
+    ShardPool(const ShardPool&) = delete;
+    ShardPool& operator=(const ShardPool&) = delete;
+
+    /**
+     * @brief Advances every server by one clock cycle.
+     *
+     * Servers must not be added or removed while this runs.
+     *
+     * @param pool Servers to tick
+     * @param finished Resized to one word per block and filled with a bit
+     *        for every server that became idle this cycle
+     */
+    void tick(ServerPool& pool, std::vector<uint64_t>& finished);
+
+    /**
+     * @brief Returns the number of shards.
+     *
+     * @return Shard count
+     */
+    int size() const;
+};
+
+#endif // SHARDPOOL_H
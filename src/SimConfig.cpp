@@ -0,0 +1,601 @@
+/**
+ * @file SimConfig.cpp
+ * @brief Implementation of simulation settings and config file parsing.
+ *
+ * This file implements setting simulation parameters by name and
+ * reading scenario config files.
+ */
+
+#include "SimConfig.h"
+#include "Request.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+
+/**
+ * @brief Parses a whole string as an integer.
+ *
+ * @param text Text to parse.
+ * @param value Receives the number.
+ * @return true if the text is a valid integer.
+ */
+static bool parseInt(const std::string& text, long long& value) {
+    char* end = nullptr;
+    value = std::strtoll(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0';
+}
+
+/**
+ * @brief Parses a whole string as an unsigned 64-bit integer.
+ *
+ * @param text Text to parse.
+ * @param value Receives the number.
+ * @return true if the text is a non-negative integer that fits.
+ */
+static bool parseUint64(const std::string& text, uint64_t& value) {
+    // strtoull would accept leading space and wrap a minus sign around
+    if (text.empty() || text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(text.c_str(), &end, 10);
+    return *end == '\0' && errno != ERANGE;
+}
+
+/**
+ * @brief Parses a whole string as a floating point number.
+ *
+ * @param text Text to parse.
+ * @param value Receives the number.
+ * @return true if the text is a valid number.
+ */
+static bool parseDouble(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+/**
+ * @brief Parses numbers separated by ':'.
+ *
+ * @param text Text to parse.
+ * @param values Receives the numbers in order.
+ * @return true if every entry is a valid number.
+ */
+static bool parseDoubleList(const std::string& text, std::vector<double>& values) {
+    values.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t colon = text.find(':', start);
+        if (colon == std::string::npos) {
+            colon = text.size();
+        }
+        double value;
+        if (!parseDouble(text.substr(start, colon - start), value)) {
+            return false;
+        }
+        values.push_back(value);
+        start = colon + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a boolean written as true/false, yes/no, on/off or 1/0.
+ *
+ * @param text Text to parse.
+ * @param value Receives the flag.
+ * @return true if the text is a valid boolean.
+ */
+static bool parseBool(const std::string& text, bool& value) {
+    if (text == "true" || text == "yes" || text == "on" || text == "1") {
+        value = true;
+        return true;
+    }
+    if (text == "false" || text == "no" || text == "off" || text == "0") {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Removes leading and trailing whitespace.
+ *
+ * @param text Text to trim.
+ * @return Trimmed copy.
+ */
+static std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Parses "name:count[:speed[:jobs[:slots]]]" pool specs separated by ';'.
+ *
+ * @param text Text to parse.
+ * @param classes Receives the pools in order.
+ * @return true if every spec is well formed.
+ */
+static bool parseServerClasses(const std::string& text, std::vector<ServerClass>& classes) {
+    classes.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(';', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        std::vector<std::string> fields;
+        std::string spec = text.substr(start, end - start);
+        size_t from = 0;
+        while (from <= spec.size()) {
+            size_t colon = spec.find(':', from);
+            if (colon == std::string::npos) {
+                colon = spec.size();
+            }
+            fields.push_back(spec.substr(from, colon - from));
+            from = colon + 1;
+        }
+
+        ServerClass serverClass;
+        long long count;
+        if (fields.size() < 2 || fields.size() > 5 || fields[0].empty()
+            || !parseInt(fields[1], count) || count < 1 || count > 2147483647LL) {
+            return false;
+        }
+        serverClass.name = fields[0];
+        serverClass.count = static_cast<int>(count);
+        if (fields.size() > 2 && (!parseDouble(fields[2], serverClass.speed) || serverClass.speed <= 0.0)) {
+            return false;
+        }
+        if (fields.size() > 3) {
+            if (fields[3] == "streaming") {
+                serverClass.jobs = JobAffinity::Streaming;
+            } else if (fields[3] == "processing") {
+                serverClass.jobs = JobAffinity::Processing;
+            } else if (fields[3] != "any") {
+                return false;
+            }
+        }
+        long long slots;
+        if (fields.size() > 4) {
+            if (!parseInt(fields[4], slots) || slots < 1 || slots > SimConfig::MAX_SLOTS) {
+                return false;
+            }
+            serverClass.slots = static_cast<int>(slots);
+        }
+        classes.push_back(serverClass);
+        start = end + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Changes one setting by name.
+ *
+ * @param key Setting name.
+ * @param value New value as text.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the key is known and the value is valid.
+ */
+bool SimConfig::set(const std::string& key, const std::string& value, std::string& error) {
+    struct IntSetting {
+        const char* name;
+        int SimConfig::*field;
+    };
+    static const IntSetting intSettings[] = {
+        {"servers", &SimConfig::servers},
+        {"cycles", &SimConfig::cycles},
+        {"initial-queue", &SimConfig::initialQueuePerServer},
+        {"scale-wait", &SimConfig::scaleWait},
+        {"scale-up", &SimConfig::scaleUpFactor},
+        {"scale-down", &SimConfig::scaleDownFactor},
+        {"stream-min", &SimConfig::streamMin},
+        {"stream-max", &SimConfig::streamMax},
+        {"proc-min", &SimConfig::procMin},
+        {"proc-max", &SimConfig::procMax},
+        {"log-interval", &SimConfig::logInterval},
+        {"diurnal-period", &SimConfig::diurnalPeriod},
+        {"duration-cap", &SimConfig::durationCap},
+        {"clients", &SimConfig::clients},
+        {"log-sample", &SimConfig::logSample},
+        {"shards", &SimConfig::shards},
+        {"runs", &SimConfig::runs},
+        {"server-queue", &SimConfig::serverQueue},
+        {"server-slots", &SimConfig::serverSlots},
+        {"sticky-flows", &SimConfig::stickyFlows},
+        {"sticky-ttl", &SimConfig::stickyTtl},
+        {"scale-interval", &SimConfig::scaleInterval},
+        {"target-wait", &SimConfig::targetWait},
+        {"scale-step", &SimConfig::scaleStep},
+        {"max-servers", &SimConfig::maxServers},
+        {"checkpoint-every", &SimConfig::checkpointEvery},
+        {"metrics-port", &SimConfig::metricsPort},
+        {"metrics-interval", &SimConfig::metricsInterval},
+        {"cluster", &SimConfig::clusterNodes},
+        {"cluster-epoch", &SimConfig::clusterEpoch},
+        {"cluster-steal", &SimConfig::clusterSteal},
+        {"cluster-vnodes", &SimConfig::clusterVnodes},
+    };
+
+    for (const IntSetting& setting : intSettings) {
+        if (key == setting.name) {
+            long long number;
+            if (!parseInt(value, number) || number < 0 || number > 2147483647LL) {
+                error = "invalid value '" + value + "' for " + key;
+                return false;
+            }
+            this->*setting.field = static_cast<int>(number);
+            return true;
+        }
+    }
+
+    bool ok = true;
+    if (key == "seed") {
+        ok = parseUint64(value, seed);
+    } else if (key == "arrival") {
+        ok = parseDouble(value, arrivalProbability)
+          && arrivalProbability >= 0.0 && arrivalProbability <= 1.0;
+    } else if (key == "workload") {
+        ok = value == "bernoulli" || value == "poisson" || value == "diurnal" || value == "mmpp";
+        if (ok) {
+            workload = value;
+        }
+    } else if (key == "arrival-rate") {
+        ok = parseDouble(value, arrivalRate) && arrivalRate >= 0.0 && arrivalRate <= MAX_ARRIVAL_RATE;
+    } else if (key == "diurnal-amplitude") {
+        ok = parseDouble(value, diurnalAmplitude) && diurnalAmplitude >= 0.0 && diurnalAmplitude <= 1.0;
+    } else if (key == "durations") {
+        ok = value == "uniform" || value == "pareto";
+        if (ok) {
+            durations = value;
+        }
+    } else if (key == "pareto-shape") {
+        ok = parseDouble(value, paretoShape) && paretoShape > 0.0;
+    } else if (key == "progress") {
+        ok = parseBool(value, progress);
+    } else if (key == "event") {
+        ok = parseBool(value, eventDriven);
+    } else if (key == "log") {
+        logPath = value;
+    } else if (key == "series") {
+        seriesPath = value;
+    } else if (key == "profile-trace") {
+        profileTracePath = value;
+    } else if (key == "blocklist") {
+        blocklistPath = value;
+    } else if (key == "trace") {
+        tracePath = value;
+    } else if (key == "server-classes") {
+        std::vector<ServerClass> parsed;
+        ok = parseServerClasses(value, parsed);
+        if (ok) {
+            serverClasses = parsed;
+        }
+    } else if (key == "checkpoint") {
+        checkpointPath = value;
+    } else if (key == "restore") {
+        restorePath = value;
+    } else if (key == "metrics-statsd") {
+        metricsStatsd = value;
+    } else if (key == "dispatch") {
+        ok = value == "first-idle" || value == "round-robin" || value == "least-work"
+          || value == "p2c" || value == "weighted";
+        if (ok) {
+            dispatch = value;
+        }
+    } else if (key == "sticky") {
+        ok = value == "off" || value == "streaming" || value == "all";
+        if (ok) {
+            sticky = value;
+        }
+    } else if (key == "autoscale") {
+        ok = value == "threshold" || value == "predictive";
+        if (ok) {
+            autoscale = value;
+        }
+    } else if (key == "scale-alpha") {
+        ok = parseDouble(value, scaleAlpha) && scaleAlpha > 0.0 && scaleAlpha <= 1.0;
+    } else if (key == "scale-hysteresis") {
+        ok = parseDouble(value, scaleHysteresis) && scaleHysteresis >= 0.0 && scaleHysteresis < 1.0;
+    } else if (key == "weights") {
+        std::vector<double> parsed;
+        ok = parseDoubleList(value, parsed);
+        for (double weight : parsed) {
+            ok = ok && weight > 0.0;
+        }
+        if (ok) {
+            weights = parsed;
+        }
+    } else if (key == "mmpp-rates") {
+        std::vector<double> parsed;
+        ok = parseDoubleList(value, parsed);
+        for (double mean : parsed) {
+            ok = ok && mean >= 0.0 && mean <= MAX_ARRIVAL_RATE;
+        }
+        if (ok) {
+            mmppRates = parsed;
+        }
+    } else if (key == "mmpp-dwell") {
+        std::vector<double> parsed;
+        ok = parseDoubleList(value, parsed);
+        for (double cycles : parsed) {
+            ok = ok && cycles >= 1.0;
+        }
+        if (ok) {
+            mmppDwell = parsed;
+        }
+    } else if (key == "log-level") {
+        if (value == "quiet") {
+            logLevel = LogLevel::Quiet;
+        } else if (value == "scale") {
+            logLevel = LogLevel::Scaling;
+        } else if (value == "state") {
+            logLevel = LogLevel::State;
+        } else {
+            ok = false;
+        }
+    } else {
+        error = "unknown setting '" + key + "'";
+        return false;
+    }
+
+    if (!ok) {
+        error = "invalid value '" + value + "' for " + key;
+    }
+    return ok;
+}
+
+/**
+ * @brief Returns the server pools the simulation starts with.
+ *
+ * @return serverClasses, or one "default" pool of servers servers.
+ */
+std::vector<ServerClass> SimConfig::pools() const {
+    if (!serverClasses.empty()) {
+        return serverClasses;
+    }
+    ServerClass serverClass;
+    serverClass.name = "default";
+    serverClass.count = servers;
+    serverClass.slots = serverSlots;
+    return std::vector<ServerClass>(1, serverClass);
+}
+
+/**
+ * @brief Checks that the settings describe a runnable simulation.
+ *
+ * @param error Receives a description of the first problem.
+ * @return true if the configuration is valid.
+ */
+bool SimConfig::validate(std::string& error) const {
+    bool servesStreaming = serverClasses.empty();
+    bool servesProcessing = serverClasses.empty();
+    for (const ServerClass& serverClass : serverClasses) {
+        servesStreaming = servesStreaming || serverClass.jobs != JobAffinity::Processing;
+        servesProcessing = servesProcessing || serverClass.jobs != JobAffinity::Streaming;
+    }
+
+    uint64_t initialServers = 0;
+    for (const ServerClass& pool : pools()) {
+        initialServers += static_cast<uint64_t>(pool.count);
+    }
+    // Every server slot owns a ring of serverQueue requests in one slab;
+    // first-idle dispatch never queues locally and reserves none
+    uint64_t slabServers = std::max(initialServers, static_cast<uint64_t>(std::max(maxServers, 0)));
+    uint64_t slabBytes = dispatch == "first-idle" ? 0
+        : slabServers * static_cast<uint64_t>(std::max(serverQueue, 0)) * sizeof(Request);
+
+    if (servers < 1 && serverClasses.empty() && restorePath.empty()) {
+        error = "servers must be at least 1";
+    } else if (tracePath.empty()
+               && initialServers * static_cast<uint64_t>(initialQueuePerServer) > MAX_INITIAL_REQUESTS) {
+        error = "initial-queue x servers must be at most " + std::to_string(MAX_INITIAL_REQUESTS);
+    } else if (serverQueue > MAX_SERVER_QUEUE) {
+        error = "server-queue must be at most " + std::to_string(MAX_SERVER_QUEUE);
+    } else if (slabBytes > MAX_LOCAL_QUEUE_BYTES) {
+        error = "server-queue x servers would take more than " + std::to_string(MAX_LOCAL_QUEUE_BYTES)
+            + " bytes of local queues";
+    } else if (cycles < 1) {
+        error = "cycles must be at least 1";
+    } else if (streamMin < 1 || streamMax < streamMin) {
+        error = "stream-min/stream-max must satisfy 1 <= min <= max";
+    } else if (procMin < 1 || procMax < procMin) {
+        error = "proc-min/proc-max must satisfy 1 <= min <= max";
+    } else if (scaleDownFactor > scaleUpFactor) {
+        error = "scale-down must not exceed scale-up";
+    } else if (diurnalPeriod < 1) {
+        error = "diurnal-period must be at least 1";
+    } else if (workload == "mmpp" && (mmppRates.empty() || mmppRates.size() != mmppDwell.size())) {
+        error = "mmpp needs mmpp-rates and mmpp-dwell with one entry per state";
+    } else if (durationCap < 1) {
+        error = "duration-cap must be at least 1";
+    } else if (logInterval < 1) {
+        error = "log-interval must be at least 1";
+    } else if (serverSlots < 1 || serverSlots > MAX_SLOTS) {
+        error = "server-slots must be between 1 and " + std::to_string(MAX_SLOTS);
+    } else if (shards > MAX_SHARDS) {
+        error = "shards must be at most " + std::to_string(MAX_SHARDS);
+    } else if (runs < 1) {
+        error = "runs must be at least 1";
+    } else if (scaleInterval < 1) {
+        error = "scale-interval must be at least 1";
+    } else if (targetWait < 1) {
+        error = "target-wait must be at least 1";
+    } else if (!servesStreaming || !servesProcessing) {
+        error = std::string("no server class accepts ") + (servesStreaming ? "processing" : "streaming") + " jobs";
+    } else if (checkpointEvery > 0 && checkpointPath.empty()) {
+        error = "checkpoint-every needs a checkpoint path";
+    } else if (stickyFlows < 1 || stickyFlows > MAX_STICKY_FLOWS) {
+        error = "sticky-flows must be between 1 and " + std::to_string(MAX_STICKY_FLOWS);
+    } else if (stickyTtl < 1) {
+        error = "sticky-ttl must be at least 1";
+    } else if (clusterNodes < 1 || clusterNodes > MAX_CLUSTER_NODES) {
+        error = "cluster must be between 1 and " + std::to_string(MAX_CLUSTER_NODES);
+    } else if (clusterEpoch < 1 || clusterVnodes < 1) {
+        error = "cluster-epoch and cluster-vnodes must be at least 1";
+    } else if (clusterNodes > 1 && eventDriven) {
+        error = "cluster runs the ticked scheduler only";
+    } else if (clusterNodes > 1 && (!tracePath.empty() || !checkpointPath.empty() || !restorePath.empty()
+                                    || metricsPort > 0 || !metricsStatsd.empty())) {
+        error = "cluster does not support trace, checkpoint, restore or metrics";
+    } else if (metricsPort > 65535) {
+        error = "metrics-port must be at most 65535";
+    } else if (metricsInterval < 1) {
+        error = "metrics-interval must be at least 1";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the list of setting names accepted by set().
+ *
+ * @return Help text with one setting per line.
+ */
+std::string SimConfig::help() {
+    return
+        "  servers N         initial number of web servers\n"
+        "  cycles N          clock cycles to simulate\n"
+        "  seed N            random seed (default: current time)\n"
+        "  arrival P         bernoulli: arrival probability per cycle (default 0.9)\n"
+        "  workload M        arrival model: bernoulli (at most one per cycle), poisson,\n"
+        "                    diurnal or mmpp (default bernoulli)\n"
+        "  arrival-rate R    poisson, diurnal: mean arrivals per cycle (default 1)\n"
+        "  diurnal-amplitude A  diurnal: mean swings over rate x (1 +/- A) (default 0.5)\n"
+        "  diurnal-period N  diurnal: cycles per period (default 1000)\n"
+        "  mmpp-rates R:R:...  mmpp: mean arrivals per cycle in each state\n"
+        "  mmpp-dwell N:N:...  mmpp: mean cycles in each state before moving to\n"
+        "                    another, chosen at random\n"
+        "  durations M       uniform within the job ranges, or pareto with the range\n"
+        "                    minimum as scale (default uniform)\n"
+        "  pareto-shape A    pareto: tail index, smaller is heavier (default 1.5)\n"
+        "  duration-cap N    pareto: longest processing time (default 10000)\n"
+        "  clients N         requests come from N fixed source addresses, chosen\n"
+        "                    uniformly; 0 = a random address each (default 0)\n"
+        "  initial-queue N   initial requests per server (default 20)\n"
+        "  scale-wait N      cooldown cycles between scaling events (default 3)\n"
+        "  scale-up N        add a server above N queued requests per server (default 25)\n"
+        "  scale-down N      remove a server below N queued requests per server (default 15)\n"
+        "  stream-min N      shortest streaming job (default 12)\n"
+        "  stream-max N      longest streaming job (default 15)\n"
+        "  proc-min N        shortest processing job (default 30)\n"
+        "  proc-max N        longest processing job (default 40)\n"
+        "  log PATH          log file; {name} expands to the scenario name (default log.txt)\n"
+        "  series PATH       also write every state line as a row of a binary columnar\n"
+        "                    time series; {name} as for log\n"
+        "  profile-trace PATH  builds with phase timing (make timing): also write every\n"
+        "                    phase of the run loop as a Chrome trace; {name} as for log\n"
+        "  log-level L       quiet, scale or state (default state)\n"
+        "  log-sample N      keep one of every N state lines (default 1)\n"
+        "  log-interval N    cycles between state lines and summaries (default 50)\n"
+        "  progress B        print periodic summaries to stdout (default true)\n"
+        "  event B           use the discrete-event scheduler (default false)\n"
+        "  shards N          threads ticking the server pool, at most 256 (default 1)\n"
+        "  blocklist PATH    CIDR blocklist file\n"
+        "  trace PATH        replay a binary trace instead of random requests; the\n"
+        "                    initial queue and arrival settings are not used\n"
+        "  runs N            repeat each scenario with seeds seed..seed+N-1 (default 1)\n"
+        "  dispatch P        first-idle, round-robin, least-work, p2c or weighted\n"
+        "                    (default first-idle)\n"
+        "  server-queue N    requests a server may queue behind its current one (default 0,\n"
+        "                    at most 65536); ignored by first-idle\n"
+        "  sticky M          pin each client to the server that first took it: off,\n"
+        "                    streaming (streaming jobs only) or all (default off); a\n"
+        "                    full home server is skipped for that request and a\n"
+        "                    removed one moves the client to a new server\n"
+        "  sticky-flows N    sticky: clients each pool remembers, the oldest expiring\n"
+        "                    first when full (default 65536)\n"
+        "  sticky-ttl N      sticky: cycles an idle client stays pinned (default 1000)\n"
+        "  server-slots N    requests each server runs at once (default 1)\n"
+        "  weights W:W:...   relative server capacities for weighted dispatch, applied\n"
+        "                    cyclically by server index (default all 1)\n"
+        "  autoscale M       threshold or predictive (default threshold)\n"
+        "  scale-interval N  predictive: cycles between scaling decisions (default 10)\n"
+        "  scale-alpha A     predictive: moving-average weight of each window (default 0.3)\n"
+        "  scale-hysteresis H  predictive: shrink only below (1 - H) x pool size (default 0.2)\n"
+        "  target-wait N     predictive: queue wait to size the pool for (default 50)\n"
+        "  scale-step N      predictive: most servers changed per decision, 0 = any (default 0)\n"
+        "  max-servers N     predictive: largest pool size, 0 = no limit (default 0)\n"
+        "  server-classes C  server pools as name:count[:speed[:jobs[:slots]]];... where\n"
+        "                    jobs is any, streaming or processing (default any) and\n"
+        "                    slots is as server-slots (default 1); a job type\n"
+        "                    with its own pools goes only to those, otherwise to the\n"
+        "                    least loaded any pool; each pool scales on its own and\n"
+        "                    the pools replace servers\n"
+        "  checkpoint PATH   save the simulation state here at the end of the run;\n"
+        "                    {name} expands to the scenario name\n"
+        "  checkpoint-every N  also save it every N cycles (default 0, end only)\n"
+        "  restore PATH      resume from a checkpoint; cycles is the cycle to stop at\n"
+        "                    and servers is not needed\n"
+        "  cluster N         run N load balancers, each on its own thread, behind a\n"
+        "                    consistent hash of the source address (default 1); each\n"
+        "                    node has servers servers and logs to log with -node<i>\n"
+        "  cluster-epoch N   cluster: cycles between routing and rebalancing (default 10)\n"
+        "  cluster-steal N   cluster: a node takes half the difference from a node whose\n"
+        "                    queue is more than N longer; 0 = never (default 100)\n"
+        "  cluster-vnodes N  cluster: hash ring points per node; fewer skews the load\n"
+        "                    (default 64)\n"
+        "  metrics-port N    serve live Prometheus metrics on http://*:N/metrics\n"
+        "                    (default 0, off); in a sweep only one run can bind it\n"
+        "  metrics-statsd H:P  push live StatsD metrics over UDP to host H, port P\n"
+        "  metrics-interval N  milliseconds between StatsD pushes (default 1000)\n"
+        "\n"
+        "In a config file, a comma-separated value (e.g. scale-up = 20,25,30)\n"
+        "sweeps that setting: every combination of listed values becomes a run.\n";
+}
+
+/**
+ * @brief Reads a config file of "key = value" lines and [scenario] headers.
+ *
+ * @param path Path of the config file.
+ * @param sections Receives the global section followed by each scenario.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the file was read.
+ */
+bool readConfigFile(const std::string& path, std::vector<ConfigSection>& sections,
+                    std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open config file " + path;
+        return false;
+    }
+
+    sections.assign(1, ConfigSection());
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        std::string where = path + ":" + std::to_string(lineNumber) + ": ";
+        if (line.front() == '[') {
+            if (line.back() != ']' || line.size() < 3) {
+                error = where + "malformed section header";
+                return false;
+            }
+            sections.push_back(ConfigSection());
+            sections.back().name = trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = where + "expected 'key = value'";
+            return false;
+        }
+        sections.back().settings.emplace_back(trim(line.substr(0, equals)),
+                                              trim(line.substr(equals + 1)));
+    }
+    return true;
+}
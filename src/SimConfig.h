@@ -0,0 +1,303 @@
+#ifndef SIMCONFIG_H
+#define SIMCONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AsyncLogger.h"
+
+/**
+ * @brief Job types a server class accepts.
+ */
+enum class JobAffinity {
+    Any,        ///< Streaming and processing jobs
+    Streaming,  ///< Streaming jobs only
+    Processing  ///< Processing jobs only
+};
+
+/**
+ * @brief One class of identical servers, scaled as its own pool.
+ */
+struct ServerClass {
+    /** Name shown in the log */
+    std::string name;
+
+    /** Servers in the pool at startup */
+    int count = 0;
+
+    /** Work units completed per cycle; a job takes ceil(time / speed) cycles */
+    double speed = 1.0;
+
+    /** Job types routed to this pool */
+    JobAffinity jobs = JobAffinity::Any;
+
+    /** Requests each server runs at once */
+    int slots = 1;
+};
+
+/**
+ * @brief Every tunable parameter of one simulation run.
+ *
+ * Defaults reproduce the original hard-coded simulation. Settings can
+ * be changed by name with set(), which is how both command-line flags
+ * (--name value) and config file lines (name = value) are applied.
+ */
+struct SimConfig {
+    /** Largest number of requests a server may run at once */
+    static constexpr int MAX_SLOTS = 1024;
+
+    /** Largest number of requests queued at startup, over every pool */
+    static constexpr uint64_t MAX_INITIAL_REQUESTS = 1ULL << 26;
+
+    /** Largest number of requests a server may hold in its local queue */
+    static constexpr int MAX_SERVER_QUEUE = 1 << 16;
+
+    /** Largest slab of server-local queues, in bytes, at the starting or largest pool size */
+    static constexpr uint64_t MAX_LOCAL_QUEUE_BYTES = 1ULL << 30;
+
+    /** Largest number of threads ticking the server pool */
+    static constexpr int MAX_SHARDS = 256;
+
+    /** Largest number of load balancers in a cluster */
+    static constexpr int MAX_CLUSTER_NODES = 256;
+
+    /** Largest flow table of a pool */
+    static constexpr int MAX_STICKY_FLOWS = 1 << 24;
+
+    /** Largest mean number of arrivals per cycle */
+    static constexpr double MAX_ARRIVAL_RATE = 1e6;
+
+    /** Initial number of web servers */
+    int servers = 0;
+
+    /** Number of clock cycles to simulate */
+    int cycles = 0;
+
+    /** Seed for the random generator */
+    uint64_t seed = 0;
+
+    /** Probability that a request arrives on a given cycle */
+    double arrivalProbability = 0.9;
+
+    /** Arrival model: "bernoulli" (arrivalProbability), "poisson", "diurnal" or "mmpp" */
+    std::string workload = "bernoulli";
+
+    /** Poisson and diurnal models: mean arrivals per cycle */
+    double arrivalRate = 1.0;
+
+    /** Diurnal model: relative swing of the mean around arrivalRate, 0 to 1 */
+    double diurnalAmplitude = 0.5;
+
+    /** Diurnal model: cycles per period of the mean */
+    int diurnalPeriod = 1000;
+
+    /** MMPP model: mean arrivals per cycle in each state */
+    std::vector<double> mmppRates;
+
+    /** MMPP model: mean cycles spent in each state before switching */
+    std::vector<double> mmppDwell;
+
+    /** Duration model: "uniform" over each job type's range, or "pareto" */
+    std::string durations = "uniform";
+
+    /** Pareto durations: tail index; smaller is heavier */
+    double paretoShape = 1.5;
+
+    /** Pareto durations: longest processing time in cycles */
+    int durationCap = 10000;
+
+    /** Distinct source addresses requests come from; 0 draws every address at random */
+    int clients = 0;
+
+    /** Initial queued requests per server */
+    int initialQueuePerServer = 20;
+
+    /** Cycles to wait after a scaling event before the next one */
+    int scaleWait = 3;
+
+    /** Add a server when the queue holds more than this many requests per server */
+    int scaleUpFactor = 25;
+
+    /** Remove a server when the queue holds fewer than this many requests per server */
+    int scaleDownFactor = 15;
+
+    /** Processing time range of streaming jobs (clock cycles, inclusive) */
+    int streamMin = 12;
+    int streamMax = 15;
+
+    /** Processing time range of processing jobs (clock cycles, inclusive) */
+    int procMin = 30;
+    int procMax = 40;
+
+    /** Cycles between state log lines and console summaries */
+    int logInterval = 50;
+
+    /** Print the periodic summary to stdout */
+    bool progress = true;
+
+    /** Path of the log file; "{name}" is replaced by the scenario name */
+    std::string logPath = "log.txt";
+
+    /** Columnar time series of the state lines; "{name}" as for logPath, empty for none */
+    std::string seriesPath;
+
+    /** Chrome trace of the run loop phases, for builds with phase timing; "{name}" as for logPath */
+    std::string profileTracePath;
+
+    /** Log detail */
+    LogLevel logLevel = LogLevel::State;
+
+    /** Keep one of every logSample state lines */
+    int logSample = 1;
+
+    /** Use the discrete-event scheduler */
+    bool eventDriven = false;
+
+    /** Number of threads ticking the server pool */
+    int shards = 1;
+
+    /** CIDR blocklist file; empty keeps the default blocked range */
+    std::string blocklistPath;
+
+    /** Binary trace to replay instead of generating random requests; empty for none */
+    std::string tracePath;
+
+    /** Number of runs of this scenario, with seeds seed, seed + 1, ... */
+    int runs = 1;
+
+    /** Dispatch policy name; "first-idle" is the original lowest-idle-index assignment */
+    std::string dispatch = "first-idle";
+
+    /** Requests each server may hold in its local queue behind the running one */
+    int serverQueue = 0;
+
+    /** Sticky routing: "off", "streaming" (pin streaming jobs) or "all" */
+    std::string sticky = "off";
+
+    /** Sticky routing: clients each pool's flow table holds */
+    int stickyFlows = 65536;
+
+    /** Sticky routing: cycles an unused client stays pinned */
+    int stickyTtl = 1000;
+
+    /** Requests each server runs at once when no server classes are given */
+    int serverSlots = 1;
+
+    /** Relative server capacities, applied cyclically by server index; empty means all 1 */
+    std::vector<double> weights;
+
+    /** Autoscaling mode: "threshold" (queue-size ratios) or "predictive" */
+    std::string autoscale = "threshold";
+
+    /** Predictive mode: cycles between scaling decisions */
+    int scaleInterval = 10;
+
+    /** Predictive mode: weight of the newest window in the moving averages */
+    double scaleAlpha = 0.3;
+
+    /** Predictive mode: shrink only when the target is this fraction below the pool size */
+    double scaleHysteresis = 0.2;
+
+    /** Predictive mode: queue wait in cycles the pool is sized to meet */
+    int targetWait = 50;
+
+    /** Predictive mode: most servers added or removed per decision; 0 for no limit */
+    int scaleStep = 0;
+
+    /** Predictive mode: largest pool size; 0 for no limit */
+    int maxServers = 0;
+
+    /** Server pools; empty for a single pool of "servers" identical servers */
+    std::vector<ServerClass> serverClasses;
+
+    /** File the simulation state is saved to at the end of the run; "{name}" as for logPath */
+    std::string checkpointPath;
+
+    /** Also save the checkpoint every this many cycles; 0 saves only at the end */
+    int checkpointEvery = 0;
+
+    /** Checkpoint to resume from; cycles is then the cycle to run up to */
+    std::string restorePath;
+
+    /** Load balancers behind the consistent-hash router; 1 runs a single balancer */
+    int clusterNodes = 1;
+
+    /** Cluster: cycles the nodes run between router steps */
+    int clusterEpoch = 10;
+
+    /** Cluster: queue length gap above which a node takes work from another; 0 never */
+    int clusterSteal = 100;
+
+    /** Cluster: points per node on the hash ring */
+    int clusterVnodes = 64;
+
+    /** TCP port serving Prometheus metrics at /metrics; 0 for none */
+    int metricsPort = 0;
+
+    /** StatsD destination as host:port; empty for none */
+    std::string metricsStatsd;
+
+    /** Milliseconds between StatsD pushes */
+    int metricsInterval = 1000;
+
+    /**
+     * @brief Changes one setting by name.
+     *
+     * @param key Setting name, e.g. "servers" or "scale-up"
+     * @param value New value as text
+     * @param error Receives a description of the problem on failure
+     * @return true if the key is known and the value is valid
+     */
+    bool set(const std::string& key, const std::string& value, std::string& error);
+
+    /**
+     * @brief Returns the server pools the simulation starts with.
+     *
+     * @return serverClasses, or one "default" pool of servers servers
+     */
+    std::vector<ServerClass> pools() const;
+
+    /**
+     * @brief Checks that the settings describe a runnable simulation.
+     *
+     * @param error Receives a description of the first problem
+     * @return true if the configuration is valid
+     */
+    bool validate(std::string& error) const;
+
+    /**
+     * @brief Returns the list of setting names accepted by set().
+     *
+     * @return Help text with one setting per line
+     */
+    static std::string help();
+};
+
+/**
+ * @brief One section of a config file.
+ *
+ * The first section returned by readConfigFile() holds the settings
+ * that appear before any [name] header and has an empty name; every
+ * other section is a named scenario.
+ */
+struct ConfigSection {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> settings;
+};
+
+/**
+ * @brief Reads a config file of "key = value" lines and [scenario] headers.
+ *
+ * Blank lines and text after '#' are ignored. Values are not checked
+ * here; apply them with SimConfig::set().
+ *
+ * @param path Path of the config file
+ * @param sections Receives the global section followed by each scenario
+ * @param error Receives a description of the problem on failure
+ * @return true if the file was read
+ */
+bool readConfigFile(const std::string& path, std::vector<ConfigSection>& sections,
+                    std::string& error);
+
+#endif // SIMCONFIG_H
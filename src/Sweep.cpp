@@ -0,0 +1,310 @@
+/**
+ * @file Sweep.cpp
+ * @brief Implementation of the parameter sweep driver.
+ *
+ * This file implements expanding scenarios into runs, running them
+ * concurrently on a work-stealing thread pool and tabulating results.
+ */
+
+#include "Sweep.h"
+#include "Cluster.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+/** A setting name with every value it takes in a sweep */
+typedef std::pair<std::string, std::vector<std::string>> SweepAxis;
+
+/**
+ * @brief Splits a comma-separated value list.
+ *
+ * @param value Text such as "20,25,30".
+ * @return Individual values with surrounding whitespace removed.
+ */
+static std::vector<std::string> splitValues(const std::string& value) {
+    std::vector<std::string> values;
+    std::stringstream in(value);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        size_t first = item.find_first_not_of(" \t");
+        size_t last = item.find_last_not_of(" \t");
+        values.push_back(first == std::string::npos ? ""
+                                                    : item.substr(first, last - first + 1));
+    }
+    return values;
+}
+
+/**
+ * @brief Inserts "-{name}" before the extension of a log path.
+ *
+ * @param path Log path without a {name} placeholder.
+ * @return Path with the placeholder added.
+ */
+static std::string addNamePlaceholder(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + "-{name}";
+    }
+    return path.substr(0, dot) + "-{name}" + path.substr(dot);
+}
+
+/**
+ * @brief Expands config file sections and command-line settings into jobs.
+ *
+ * @param defaults Starting configuration.
+ * @param sections Sections from readConfigFile(), or a single empty one.
+ * @param cliSettings Settings given on the command line.
+ * @param jobs Receives the expanded jobs.
+ * @param error Receives a description of the problem on failure.
+ * @return true if every setting was valid.
+ */
+bool buildSweep(const SimConfig& defaults,
+                const std::vector<ConfigSection>& sections,
+                const std::vector<std::pair<std::string, std::string>>& cliSettings,
+                std::vector<SweepJob>& jobs,
+                std::string& error) {
+    jobs.clear();
+
+    std::vector<ConfigSection> scenarios(sections.begin() + 1, sections.end());
+    if (scenarios.empty()) {
+        scenarios.push_back(ConfigSection());
+    }
+
+    for (const ConfigSection& scenario : scenarios) {
+        std::vector<std::pair<std::string, std::string>> settings = sections[0].settings;
+        settings.insert(settings.end(), cliSettings.begin(), cliSettings.end());
+        settings.insert(settings.end(), scenario.settings.begin(), scenario.settings.end());
+
+        // Later settings override earlier ones, so only the last value
+        // of a key decides whether it is swept
+        std::vector<SweepAxis> axes;
+        for (const auto& setting : settings) {
+            for (size_t a = 0; a < axes.size(); a++) {
+                if (axes[a].first == setting.first) {
+                    axes.erase(axes.begin() + a);
+                    break;
+                }
+            }
+            if (setting.second.find(',') != std::string::npos) {
+                axes.emplace_back(setting.first, splitValues(setting.second));
+            }
+        }
+
+        std::vector<size_t> choice(axes.size(), 0);
+        while (true) {
+            SweepJob job;
+            job.config = defaults;
+            job.name = scenario.name;
+
+            for (const auto& setting : settings) {
+                std::string value = setting.second;
+                for (size_t a = 0; a < axes.size(); a++) {
+                    if (axes[a].first == setting.first) {
+                        value = axes[a].second[choice[a]];
+                    }
+                }
+                if (!job.config.set(setting.first, value, error)) {
+                    if (!scenario.name.empty()) {
+                        error = "scenario " + scenario.name + ": " + error;
+                    }
+                    return false;
+                }
+            }
+            for (size_t a = 0; a < axes.size(); a++) {
+                job.name += (job.name.empty() ? "" : ",") + axes[a].first + "="
+                          + axes[a].second[choice[a]];
+            }
+
+            int runs = job.config.runs < 1 ? 1 : job.config.runs;
+            for (int r = 0; r < runs; r++) {
+                SweepJob run = job;
+                run.config.seed = job.config.seed + r;
+                if (runs > 1) {
+                    run.name += (run.name.empty() ? "" : ",") + std::string("run=")
+                              + std::to_string(r);
+                }
+                jobs.push_back(run);
+            }
+
+            size_t a = 0;
+            while (a < axes.size() && ++choice[a] == axes[a].second.size()) {
+                choice[a] = 0;
+                a++;
+            }
+            if (a == axes.size()) {
+                break;
+            }
+        }
+    }
+
+    if (jobs.size() > 1) {
+        for (SweepJob& job : jobs) {
+            if (job.config.logPath.find("{name}") == std::string::npos) {
+                job.config.logPath = addNamePlaceholder(job.config.logPath);
+            }
+            if (!job.config.seriesPath.empty()
+                && job.config.seriesPath.find("{name}") == std::string::npos) {
+                job.config.seriesPath = addNamePlaceholder(job.config.seriesPath);
+            }
+            if (!job.config.profileTracePath.empty()
+                && job.config.profileTracePath.find("{name}") == std::string::npos) {
+                job.config.profileTracePath = addNamePlaceholder(job.config.profileTracePath);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Replaces "{name}" in a path with the scenario name.
+ *
+ * @param path Path to expand in place.
+ * @param name Scenario name; the unnamed scenario expands to "default".
+ */
+static void expandName(std::string& path, const std::string& name) {
+    size_t placeholder = path.find("{name}");
+    if (placeholder != std::string::npos) {
+        path.replace(placeholder, 6, name.empty() ? "default" : name);
+    }
+}
+
+/**
+ * @brief Runs one job on the calling thread.
+ *
+ * @param job Job to run.
+ * @param console Stream for progress and the summary, or nullptr.
+ * @return Result of the run.
+ */
+SweepResult runJob(const SweepJob& job, std::ostream* console) {
+    SweepResult result;
+    result.ok = false;
+    result.summary = RunSummary();
+    result.wallSeconds = 0;
+
+    SimConfig config = job.config;
+    expandName(config.logPath, job.name);
+    expandName(config.seriesPath, job.name);
+    expandName(config.profileTracePath, job.name);
+    expandName(config.checkpointPath, job.name);
+    expandName(config.restorePath, job.name);
+    if (!config.validate(result.error)) {
+        return result;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (config.clusterNodes > 1) {
+        Cluster cluster(config);
+        cluster.setConsole(console);
+        if (!config.blocklistPath.empty() && !cluster.loadBlocklist(config.blocklistPath, result.error)) {
+            return result;
+        }
+        cluster.Run();
+        auto end = std::chrono::steady_clock::now();
+
+        result.ok = true;
+        result.summary = cluster.getSummary();
+        result.wallSeconds = std::chrono::duration<double>(end - start).count();
+        return result;
+    }
+
+    LoadBalancer lb(config);
+    lb.setConsole(console);
+    if (!config.blocklistPath.empty() && !lb.loadBlocklist(config.blocklistPath, result.error)) {
+        return result;
+    }
+    if (!config.tracePath.empty() && !lb.loadTrace(config.tracePath, result.error)) {
+        return result;
+    }
+    if (!config.restorePath.empty() && !lb.restoreCheckpoint(config.restorePath, result.error)) {
+        return result;
+    }
+    lb.Run();
+    auto end = std::chrono::steady_clock::now();
+
+    result.ok = true;
+    result.summary = lb.getSummary();
+    result.wallSeconds = std::chrono::duration<double>(end - start).count();
+    return result;
+}
+
+/**
+ * @brief Runs every job, several at a time on a work-stealing pool.
+ *
+ * @param jobs Jobs to run.
+ * @param threads Number of concurrent runs; 0 uses every hardware thread.
+ * @return One result per job, in job order.
+ */
+std::vector<SweepResult> runSweep(const std::vector<SweepJob>& jobs, size_t threads) {
+    std::vector<SweepResult> results(jobs.size());
+
+    if (threads == 1) {
+        for (size_t i = 0; i < jobs.size(); i++) {
+            if (!jobs[i].name.empty()) {
+                std::cout << "\n===== Scenario: " << jobs[i].name << " =====\n";
+            }
+            std::cout << "\nStarting load balancer (seed " << jobs[i].config.seed << ")...\n\n";
+            results[i] = runJob(jobs[i], &std::cout);
+        }
+        return results;
+    }
+
+    WorkStealingPool pool(threads);
+    for (size_t i = 0; i < jobs.size(); i++) {
+        pool.submit([&jobs, &results, i] {
+            results[i] = runJob(jobs[i], nullptr);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+/**
+ * @brief Prints one row per job with its final counters.
+ *
+ * @param out Destination stream.
+ * @param jobs Jobs that were run.
+ * @param results Results from runSweep(), in job order.
+ */
+void printSweepTable(std::ostream& out, const std::vector<SweepJob>& jobs,
+                     const std::vector<SweepResult>& results) {
+    size_t nameWidth = 8;
+    for (const SweepJob& job : jobs) {
+        nameWidth = std::max(nameWidth, job.name.size());
+    }
+
+    out << "\n" << std::left << std::setw(nameWidth) << "Scenario" << std::right
+        << std::setw(12) << "Seed"
+        << std::setw(8) << "Init"
+        << std::setw(8) << "Final"
+        << std::setw(12) << "Processed"
+        << std::setw(10) << "Blocked"
+        << std::setw(10) << "EndQueue"
+        << std::setw(8) << "Wait99"
+        << std::setw(8) << "Lat50"
+        << std::setw(8) << "Lat99"
+        << std::setw(10) << "Wall(s)" << "\n";
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        out << std::left << std::setw(nameWidth) << jobs[i].name << std::right
+            << std::setw(12) << jobs[i].config.seed;
+        if (!results[i].ok) {
+            out << "  FAILED: " << results[i].error << "\n";
+            continue;
+        }
+        const RunSummary& s = results[i].summary;
+        out << std::setw(8) << s.initialServers
+            << std::setw(8) << s.finalServers
+            << std::setw(12) << s.processed
+            << std::setw(10) << s.blocked
+            << std::setw(10) << s.endingQueue
+            << std::setw(8) << s.waitP99
+            << std::setw(8) << s.latencyP50
+            << std::setw(8) << s.latencyP99
+            << std::setw(10) << std::fixed << std::setprecision(3)
+            << results[i].wallSeconds << "\n";
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "LoadBalancer.h"
+#include "SimConfig.h"
+
+/**
+ * @brief One simulation run of a parameter sweep.
+ */
+struct SweepJob {
+    /** Scenario name plus the swept values, e.g. "peak,scale-up=30" */
+    std::string name;
+
+    /** Fully resolved parameters of the run */
+    SimConfig config;
+};
+
+/**
+ * @brief Outcome of one sweep job.
+ */
+struct SweepResult {
+    /** False if the job could not run; see error */
+    bool ok;
+
+    std::string error;
+    RunSummary summary;
+
+    /** Wall-clock duration of the run */
+    double wallSeconds;
+};
+
+/**
+ * @brief Expands config file sections and command-line settings into jobs.
+ *
+ * Each scenario's settings are applied in the order: file globals,
+ * command-line settings, scenario section. A comma-separated value
+ * becomes a sweep axis and every combination of axis values is a job;
+ * "runs = N" then repeats each job with consecutive seeds. With no
+ * scenario sections a single unnamed job is produced. When there is
+ * more than one job, a log or series path without "{name}" gets "-{name}"
+ * added before its extension so runs do not overwrite each other's files.
+ *
+ * @param defaults Starting configuration (e.g. with a time-based seed)
+ * @param sections Sections from readConfigFile(), or a single empty one
+ * @param cliSettings Settings given on the command line
+ * @param jobs Receives the expanded jobs
+ * @param error Receives a description of the problem on failure
+ * @return true if every setting was valid
+ */
+bool buildSweep(const SimConfig& defaults,
+                const std::vector<ConfigSection>& sections,
+                const std::vector<std::pair<std::string, std::string>>& cliSettings,
+                std::vector<SweepJob>& jobs,
+                std::string& error);
+
+/**
+ * @brief Runs one job on the calling thread.
+ *
+ * @param job Job to run
+ * @param console Stream for progress and the summary, or nullptr
+ * @return Result of the run
+ */
+SweepResult runJob(const SweepJob& job, std::ostream* console);
+
+/**
+ * @brief Runs every job, several at a time on a work-stealing pool.
+ *
+ * Each job gets its own LoadBalancer, random generator and log file.
+ * With one thread the jobs run in order on the calling thread and
+ * print to stdout as usual; with more they run silently.
+ *
+ * @param jobs Jobs to run
+ * @param threads Number of concurrent runs; 0 uses every hardware thread
+ * @return One result per job, in job order
+ */
+std::vector<SweepResult> runSweep(const std::vector<SweepJob>& jobs, size_t threads);
+
+/**
+ * @brief Prints one row per job with its final counters.
+ *
+ * @param out Destination stream
+ * @param jobs Jobs that were run
+ * @param results Results from runSweep(), in job order
+ */
+void printSweepTable(std::ostream& out, const std::vector<SweepJob>& jobs,
+                     const std::vector<SweepResult>& results);
+
+#endif // SWEEP_H
@@ -0,0 +1,73 @@
+#ifndef TIMESERIESFORMAT_H
+#define TIMESERIESFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file TimeSeriesFormat.h
+ * @brief On-disk layout of columnar time series.
+ *
+ * A series is a 32-byte header, a table of column names and then blocks
+ * of rows stored column by column. All fields are little-endian:
+ *
+ *     header:  char magic[8] = "LBSERIE1", uint32 version = 1,
+ *              uint32 columns, uint32 blockRows, uint32 dataOffset,
+ *              uint64 rows
+ *     names:   columns x char[32], NUL padded
+ *     blocks:  from dataOffset (a multiple of 64), each holding
+ *              blockRows int64 values of column 0, then of column 1, ...
+ *
+ * Value r of column c is therefore at
+ *
+ *     dataOffset + ((r / blockRows) * columns + c) * blockRows * 8
+ *                + (r % blockRows) * 8
+ *
+ * so a mapped file is a (blocks, columns, blockRows) int64 array in
+ * which every column of a block is contiguous. The last block is padded
+ * with zeros; rows gives the real count. The writer updates rows after
+ * every block, so a series cut short by a crash still reads back up to
+ * its last complete block.
+ */
+
+/** Magic bytes at the start of every series */
+static const char SERIES_MAGIC[8] = {'L', 'B', 'S', 'E', 'R', 'I', 'E', '1'};
+
+/** Current series format version */
+static const uint32_t SERIES_VERSION = 1;
+
+/** Size of the series header in bytes */
+static const size_t SERIES_HEADER_BYTES = 32;
+
+/** Size of one column name, including its terminating NUL */
+static const size_t SERIES_NAME_BYTES = 32;
+
+/** Alignment of the first block */
+static const size_t SERIES_DATA_ALIGN = 64;
+
+/**
+ * @brief Fixed header at the start of a series file.
+ */
+struct SeriesHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columns;
+    uint32_t blockRows;
+    uint32_t dataOffset;
+    uint64_t rows;
+};
+
+static_assert(sizeof(SeriesHeader) == SERIES_HEADER_BYTES, "SeriesHeader must be 32 bytes");
+
+/**
+ * @brief Returns where the first block of a series starts.
+ *
+ * @param columns Number of columns
+ * @return Offset of the first block in bytes
+ */
+inline size_t seriesDataOffset(size_t columns) {
+    size_t end = SERIES_HEADER_BYTES + columns * SERIES_NAME_BYTES;
+    return (end + SERIES_DATA_ALIGN - 1) / SERIES_DATA_ALIGN * SERIES_DATA_ALIGN;
+}
+
+#endif // TIMESERIESFORMAT_H
@@ -0,0 +1,212 @@
+/**
+ * @file TimeSeriesReader.cpp
+ * @brief Implementation of memory-mapped series reading and CSV export.
+ *
+ * This file implements mapping and validating a columnar series and
+ * the exporter that writes one back out as CSV.
+ */
+
+#include "TimeSeriesReader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructs a reader with no series open.
+ */
+TimeSeriesReader::TimeSeriesReader()
+    : base(nullptr),
+      mappedBytes(0),
+      data(nullptr),
+      rowCount(0),
+      blockRows(1)
+{
+}
+
+/**
+ * @brief Unmaps the series.
+ */
+TimeSeriesReader::~TimeSeriesReader() {
+    close();
+}
+
+/**
+ * @brief Maps a series file and validates its header.
+ *
+ * Checks the magic, version and layout, and that the file holds every
+ * block the row count needs.
+ *
+ * @param path Path of the series.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the series is ready to read.
+ */
+bool TimeSeriesReader::open(const std::string& path, std::string& error) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open series " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < SERIES_HEADER_BYTES) {
+        ::close(fd);
+        error = path + ": not a series file";
+        return false;
+    }
+
+    mappedBytes = info.st_size;
+    void* map = mmap(nullptr, mappedBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        mappedBytes = 0;
+        error = "cannot map series " + path;
+        return false;
+    }
+    base = static_cast<const unsigned char*>(map);
+
+    SeriesHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    uint64_t blocks = header.blockRows == 0 ? 0 : (header.rows + header.blockRows - 1) / header.blockRows;
+    uint64_t blockBytes = static_cast<uint64_t>(header.columns) * header.blockRows * sizeof(int64_t);
+    if (std::memcmp(header.magic, SERIES_MAGIC, sizeof(SERIES_MAGIC)) != 0) {
+        error = path + ": not a series file";
+    } else if (header.version != SERIES_VERSION) {
+        error = path + ": unsupported series version";
+    } else if (header.columns == 0 || header.blockRows == 0
+               || header.dataOffset != seriesDataOffset(header.columns)
+               || header.dataOffset > mappedBytes) {
+        error = path + ": malformed series header";
+    } else if (blocks > (mappedBytes - header.dataOffset) / blockBytes) {
+        error = path + ": truncated series";
+    } else {
+        const char* table = reinterpret_cast<const char*>(base + SERIES_HEADER_BYTES);
+        for (uint32_t c = 0; c < header.columns; c++) {
+            const char* name = table + c * SERIES_NAME_BYTES;
+            names.emplace_back(name, strnlen(name, SERIES_NAME_BYTES));
+        }
+        data = reinterpret_cast<const int64_t*>(base + header.dataOffset);
+        rowCount = header.rows;
+        blockRows = header.blockRows;
+        return true;
+    }
+    close();
+    return false;
+}
+
+/**
+ * @brief Unmaps the series.
+ */
+void TimeSeriesReader::close() {
+    if (base) {
+        munmap(const_cast<unsigned char*>(base), mappedBytes);
+    }
+    base = nullptr;
+    mappedBytes = 0;
+    data = nullptr;
+    rowCount = 0;
+    blockRows = 1;
+    names.clear();
+}
+
+/**
+ * @brief Returns the number of rows.
+ *
+ * @return Row count.
+ */
+size_t TimeSeriesReader::rows() const {
+    return rowCount;
+}
+
+/**
+ * @brief Returns the number of columns.
+ *
+ * @return Column count.
+ */
+size_t TimeSeriesReader::columns() const {
+    return names.size();
+}
+
+/**
+ * @brief Returns the name of a column.
+ *
+ * @param column Column index.
+ * @return Column name.
+ */
+const std::string& TimeSeriesReader::columnName(size_t column) const {
+    return names[column];
+}
+
+/**
+ * @brief Looks up a column by name.
+ *
+ * @param name Column name.
+ * @return Column index, or NONE.
+ */
+size_t TimeSeriesReader::findColumn(const std::string& name) const {
+    auto found = std::find(names.begin(), names.end(), name);
+    return found == names.end() ? NONE : static_cast<size_t>(found - names.begin());
+}
+
+/**
+ * @brief Returns the values of one column from row first onwards,
+ *        up to the end of the block holding that row.
+ *
+ * @param first First row.
+ * @param column Column index.
+ * @param values Receives a pointer to the value of row first.
+ * @return Number of consecutive rows available at values.
+ */
+size_t TimeSeriesReader::columnRun(size_t first, size_t column, const int64_t*& values) const {
+    if (first >= rowCount) {
+        values = nullptr;
+        return 0;
+    }
+    size_t offset = first % blockRows;
+    values = data + ((first / blockRows) * names.size() + column) * blockRows + offset;
+    return std::min(blockRows - offset, rowCount - first);
+}
+
+/**
+ * @brief Writes a series as CSV.
+ *
+ * @param seriesPath Path of the series.
+ * @param csvPath Path of the CSV file to write.
+ * @param rows Receives the number of rows written.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the CSV file was written.
+ */
+bool exportSeriesCsv(const std::string& seriesPath, const std::string& csvPath,
+                     uint64_t& rows, std::string& error) {
+    TimeSeriesReader reader;
+    if (!reader.open(seriesPath, error)) {
+        return false;
+    }
+    std::FILE* out = std::fopen(csvPath.c_str(), "w");
+    if (!out) {
+        error = "cannot create " + csvPath;
+        return false;
+    }
+
+    for (size_t c = 0; c < reader.columns(); c++) {
+        std::fprintf(out, c == 0 ? "%s" : ",%s", reader.columnName(c).c_str());
+    }
+    std::fputc('\n', out);
+    for (size_t r = 0; r < reader.rows(); r++) {
+        for (size_t c = 0; c < reader.columns(); c++) {
+            std::fprintf(out, c == 0 ? "%lld" : ",%lld", static_cast<long long>(reader.value(r, c)));
+        }
+        std::fputc('\n', out);
+    }
+
+    if (std::fclose(out) != 0) {
+        error = "write failed: " + csvPath;
+        return false;
+    }
+    rows = reader.rows();
+    return true;
+}
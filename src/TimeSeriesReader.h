@@ -0,0 +1,124 @@
+#ifndef TIMESERIESREADER_H
+#define TIMESERIESREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TimeSeriesFormat.h"
+
+/**
+ * @brief Reads a columnar series through a read-only memory map.
+ *
+ * Opening validates the header and maps the file; nothing is decoded.
+ * Values are read straight from the map, either one at a time or as the
+ * contiguous run of one column within a block.
+ */
+class TimeSeriesReader {
+private:
+    const unsigned char* base;
+    size_t mappedBytes;
+    const int64_t* data;
+    size_t rowCount;
+    size_t blockRows;
+    std::vector<std::string> names;
+
+public:
+    /** Returned by findColumn() for an unknown name */
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    /**
+     * @brief Constructs a reader with no series open.
+     */
+    TimeSeriesReader();
+
+    /**
+     * @brief Unmaps the series.
+     */
+    ~TimeSeriesReader();
+
+    TimeSeriesReader(const TimeSeriesReader&) = delete;
+    TimeSeriesReader& operator=(const TimeSeriesReader&) = delete;
+
+    /**
+     * @brief Maps a series file and validates its header.
+     *
+     * @param path Path of the series
+     * @param error Receives a description of the problem on failure
+     * @return true if the series is ready to read
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Unmaps the series.
+     */
+    void close();
+
+    /**
+     * @brief Returns the number of rows.
+     *
+     * @return Row count
+     */
+    size_t rows() const;
+
+    /**
+     * @brief Returns the number of columns.
+     *
+     * @return Column count
+     */
+    size_t columns() const;
+
+    /**
+     * @brief Returns the name of a column.
+     *
+     * @param column Column index
+     * @return Column name
+     */
+    const std::string& columnName(size_t column) const;
+
+    /**
+     * @brief Looks up a column by name.
+     *
+     * @param name Column name
+     * @return Column index, or NONE
+     */
+    size_t findColumn(const std::string& name) const;
+
+    /**
+     * @brief Returns one value.
+     *
+     * @param row Row index, below rows()
+     * @param column Column index, below columns()
+     * @return Stored value
+     */
+    int64_t value(size_t row, size_t column) const {
+        return data[((row / blockRows) * names.size() + column) * blockRows + row % blockRows];
+    }
+
+    /**
+     * @brief Returns the values of one column from row first onwards,
+     *        up to the end of the block holding that row.
+     *
+     * @param first First row, below rows()
+     * @param column Column index, below columns()
+     * @param values Receives a pointer to the value of row first
+     * @return Number of consecutive rows available at values
+     */
+    size_t columnRun(size_t first, size_t column, const int64_t*& values) const;
+};
+
+/**
+ * @brief Writes a series as CSV.
+ *
+ * The first line names the columns; each further line is one row.
+ *
+ * @param seriesPath Path of the series
+ * @param csvPath Path of the CSV file to write
+ * @param rows Receives the number of rows written
+ * @param error Receives a description of the problem on failure
+ * @return true if the CSV file was written
+ */
+bool exportSeriesCsv(const std::string& seriesPath, const std::string& csvPath,
+                     uint64_t& rows, std::string& error);
+
+#endif // TIMESERIESREADER_H
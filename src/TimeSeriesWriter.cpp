@@ -0,0 +1,168 @@
+/**
+ * @file TimeSeriesWriter.cpp
+ * @brief Implementation of block-buffered columnar series writing.
+ *
+ * This file implements the writer that collects rows into column-major
+ * blocks and appends them to a series file.
+ */
+
+#include "TimeSeriesWriter.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Constructs a writer with no file open.
+ */
+TimeSeriesWriter::TimeSeriesWriter()
+    : file(nullptr),
+      columnCount(0),
+      blockFill(0),
+      written(0)
+{
+}
+
+/**
+ * @brief Closes the file if it is still open.
+ */
+TimeSeriesWriter::~TimeSeriesWriter() {
+    std::string ignored;
+    close(ignored);
+}
+
+/**
+ * @brief Creates or truncates a series file.
+ *
+ * Writes the header, with no rows, and the column names.
+ *
+ * @param path Path of the series.
+ * @param columns Column names.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the file was created.
+ */
+bool TimeSeriesWriter::open(const std::string& path, const std::vector<std::string>& columns,
+                            std::string& error) {
+    std::string ignored;
+    close(ignored);
+
+    if (columns.empty()) {
+        error = "a series needs at least one column";
+        return false;
+    }
+    for (const std::string& name : columns) {
+        if (name.empty() || name.size() >= SERIES_NAME_BYTES) {
+            error = "series column name '" + name + "' must be 1 to "
+                  + std::to_string(SERIES_NAME_BYTES - 1) + " characters";
+            return false;
+        }
+    }
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create series " + path;
+        return false;
+    }
+    columnCount = columns.size();
+    block.assign(columnCount * BLOCK_ROWS, 0);
+    blockFill = 0;
+    written = 0;
+
+    std::vector<char> names(seriesDataOffset(columnCount) - SERIES_HEADER_BYTES, '\0');
+    for (size_t c = 0; c < columnCount; c++) {
+        std::memcpy(&names[c * SERIES_NAME_BYTES], columns[c].data(), columns[c].size());
+    }
+    bool ok = writeHeader()
+           && std::fwrite(names.data(), 1, names.size(), file) == names.size();
+    if (!ok) {
+        std::fclose(file);
+        file = nullptr;
+        error = "cannot write series " + path;
+    }
+    return ok;
+}
+
+/**
+ * @brief Appends one row.
+ *
+ * @param values One value per column.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the row was accepted.
+ */
+bool TimeSeriesWriter::append(const int64_t* values, std::string& error) {
+    if (!file) {
+        error = "series is not open";
+        return false;
+    }
+    for (size_t c = 0; c < columnCount; c++) {
+        block[c * BLOCK_ROWS + blockFill] = values[c];
+    }
+    blockFill++;
+    written++;
+    if (blockFill == BLOCK_ROWS && !flushBlock()) {
+        error = "write failed";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the buffered block, padded with zeros, and the header.
+ *
+ * @return true if the block and header were written.
+ */
+bool TimeSeriesWriter::flushBlock() {
+    if (blockFill == 0) {
+        return true;
+    }
+    bool ok = std::fwrite(block.data(), sizeof(int64_t), block.size(), file) == block.size();
+    std::fill(block.begin(), block.end(), 0);
+    blockFill = 0;
+    return ok && writeHeader() && std::fseek(file, 0, SEEK_END) == 0;
+}
+
+/**
+ * @brief Rewrites the header with the current row count.
+ *
+ * Rows still in the block buffer are not counted. Leaves the file
+ * position just after the header.
+ *
+ * @return true if the header was written.
+ */
+bool TimeSeriesWriter::writeHeader() {
+    SeriesHeader header = SeriesHeader();
+    std::memcpy(header.magic, SERIES_MAGIC, sizeof(SERIES_MAGIC));
+    header.version = SERIES_VERSION;
+    header.columns = static_cast<uint32_t>(columnCount);
+    header.blockRows = static_cast<uint32_t>(BLOCK_ROWS);
+    header.dataOffset = static_cast<uint32_t>(seriesDataOffset(columnCount));
+    header.rows = written - blockFill;
+    return std::fseek(file, 0, SEEK_SET) == 0
+        && std::fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+/**
+ * @brief Writes the last partial block and the final header.
+ *
+ * @param error Receives a description of the problem on failure.
+ * @return true if the series is complete.
+ */
+bool TimeSeriesWriter::close(std::string& error) {
+    if (!file) {
+        return true;
+    }
+    bool ok = flushBlock();
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        error = "write failed";
+    }
+    return ok;
+}
+
+/**
+ * @brief Returns the number of rows appended so far.
+ *
+ * @return Row count.
+ */
+uint64_t TimeSeriesWriter::size() const {
+    return written;
+}
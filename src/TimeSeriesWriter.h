@@ -0,0 +1,89 @@
+#ifndef TIMESERIESWRITER_H
+#define TIMESERIESWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "TimeSeriesFormat.h"
+
+/**
+ * @brief Appends rows of fixed-width integer columns to a series file.
+ *
+ * Rows are collected column by column in a block buffer, and each full
+ * block is written with a single call, followed by a header holding the
+ * new row count. Appending a row is therefore a handful of stores.
+ */
+class TimeSeriesWriter {
+private:
+    std::FILE* file;
+    size_t columnCount;
+    std::vector<int64_t> block;
+    size_t blockFill;
+    uint64_t written;
+
+    /**
+     * @brief Writes the buffered block, padded with zeros, and the header.
+     */
+    bool flushBlock();
+
+    /**
+     * @brief Rewrites the header with the current row count.
+     */
+    bool writeHeader();
+
+public:
+    /** Rows buffered per block */
+    static constexpr size_t BLOCK_ROWS = 1024;
+
+    /**
+     * @brief Constructs a writer with no file open.
+     */
+    TimeSeriesWriter();
+
+    /**
+     * @brief Closes the file if it is still open.
+     */
+    ~TimeSeriesWriter();
+
+    TimeSeriesWriter(const TimeSeriesWriter&) = delete;
+    TimeSeriesWriter& operator=(const TimeSeriesWriter&) = delete;
+
+    /**
+     * @brief Creates or truncates a series file.
+     *
+     * @param path Path of the series
+     * @param columns Column names, each shorter than 32 characters
+     * @param error Receives a description of the problem on failure
+     * @return true if the file was created
+     */
+    bool open(const std::string& path, const std::vector<std::string>& columns,
+              std::string& error);
+
+    /**
+     * @brief Appends one row.
+     *
+     * @param values One value per column
+     * @param error Receives a description of the problem on failure
+     * @return true if the row was accepted
+     */
+    bool append(const int64_t* values, std::string& error);
+
+    /**
+     * @brief Writes the last partial block and the final header.
+     *
+     * @param error Receives a description of the problem on failure
+     * @return true if the series is complete
+     */
+    bool close(std::string& error);
+
+    /**
+     * @brief Returns the number of rows appended so far.
+     *
+     * @return Row count
+     */
+    uint64_t size() const;
+};
+
+#endif // TIMESERIESWRITER_H
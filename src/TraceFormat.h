@@ -0,0 +1,107 @@
+#ifndef TRACEFORMAT_H
+#define TRACEFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include "Request.h"
+
+/**
+ * @file TraceFormat.h
+ * @brief On-disk layout of binary request traces.
+ *
+ * A trace is a 32-byte header followed by fixed 16-byte records sorted
+ * by arrival cycle. All fields are little-endian:
+ *
+ *     header:  char magic[8] = "LBTRACE1", uint32 version = 1,
+ *              uint32 recordBytes = 16, uint64 count, uint64 reserved
+ *     record:  uint32 ipIn, uint32 ipOut,
+ *              uint32 duration | streaming << 31, int32 arrival
+ *
+ * The record layout matches the in-memory layout of Request on the
+ * little-endian targets we build for, so a mapped trace can be copied
+ * into the request queue without decoding.
+ */
+
+/** Magic bytes at the start of every trace */
+static const char TRACE_MAGIC[8] = {'L', 'B', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/** Current trace format version */
+static const uint32_t TRACE_VERSION = 1;
+
+/** Size of the trace header in bytes */
+static const size_t TRACE_HEADER_BYTES = 32;
+
+/** Size of one trace record in bytes */
+static const size_t TRACE_RECORD_BYTES = 16;
+
+/** Longest processing time a record can hold, in cycles */
+static const uint32_t TRACE_MAX_DURATION = 0x7FFFFFFFu;
+
+/**
+ * @brief Fixed header at the start of a trace file.
+ */
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordBytes;
+    uint64_t count;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(TraceHeader) == TRACE_HEADER_BYTES, "TraceHeader must be 32 bytes");
+
+/**
+ * @brief One trace record with its fields spelled out.
+ */
+struct TraceRecord {
+    uint32_t ipIn;
+    uint32_t ipOut;
+    uint32_t durationAndFlag;
+    int32_t arrival;
+};
+
+static_assert(sizeof(TraceRecord) == TRACE_RECORD_BYTES, "TraceRecord must be 16 bytes");
+
+/**
+ * @brief Builds a trace record.
+ *
+ * @param arrival Arrival cycle
+ * @param ipIn Source address (packed IPv4)
+ * @param ipOut Destination address (packed IPv4)
+ * @param streaming True for a streaming job
+ * @param duration Processing time in cycles, at most TRACE_MAX_DURATION
+ * @return Encoded record
+ */
+inline TraceRecord makeTraceRecord(int arrival, uint32_t ipIn, uint32_t ipOut,
+                                   bool streaming, uint32_t duration) {
+    TraceRecord record;
+    record.ipIn = ipIn;
+    record.ipOut = ipOut;
+    record.durationAndFlag = (duration & TRACE_MAX_DURATION) | (streaming ? 0x80000000u : 0u);
+    record.arrival = arrival;
+    return record;
+}
+
+/**
+ * @brief Converts a trace record to a Request.
+ *
+ * @param record Encoded record
+ * @return Equivalent request
+ */
+inline Request decodeTraceRecord(const TraceRecord& record) {
+    return Request(record.ipIn, record.ipOut, (record.durationAndFlag >> 31) != 0,
+                   static_cast<int>(record.durationAndFlag & TRACE_MAX_DURATION), record.arrival);
+}
+
+/**
+ * @brief Checks whether Request shares the trace record layout.
+ *
+ * @return true if records can be copied into Request arrays unchanged
+ */
+inline bool traceMatchesRequestLayout() {
+    TraceRecord record = makeTraceRecord(77, 0x01020304u, 0x05060708u, true, 12345);
+    Request request = decodeTraceRecord(record);
+    return std::memcmp(&record, &request, sizeof(record)) == 0;
+}
+
+#endif // TRACEFORMAT_H
@@ -0,0 +1,239 @@
+/**
+ * @file TraceReader.cpp
+ * @brief Implementation of memory-mapped trace replay.
+ *
+ * This file implements mapping a binary trace, validating it and
+ * handing out the requests whose arrival cycle has come up.
+ */
+
+#include "TraceReader.h"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Replayed bytes accumulated before their pages are released */
+static const size_t RELEASE_BYTES = 64u << 20;
+
+/** Most records decoded per call when the layout does not match */
+static const size_t DECODE_BATCH = 4096;
+
+/**
+ * @brief Finds the first record whose duration is out of range.
+ *
+ * The 31-bit field cannot hold more than TRACE_MAX_DURATION, so only a
+ * zero duration is out of range.
+ *
+ * @param records First record.
+ * @param n Number of records.
+ * @return Index of the first bad record, or n if every duration is valid.
+ */
+static size_t findBadDuration(const TraceRecord* records, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if ((records[i].durationAndFlag & TRACE_MAX_DURATION) < 1) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Constructs a reader with no trace open.
+ */
+TraceReader::TraceReader()
+    : base(nullptr),
+      mappedBytes(0),
+      records(nullptr),
+      count(0),
+      position(0),
+      releasedBytes(0),
+      zeroCopy(true)
+{
+}
+
+/**
+ * @brief Unmaps the trace.
+ */
+TraceReader::~TraceReader() {
+    close();
+}
+
+/**
+ * @brief Maps a trace file and validates its header and records.
+ *
+ * Checks the magic, version, record size and that the file holds every
+ * record the header announces, then that every record's duration is
+ * between 1 and TRACE_MAX_DURATION. A zero duration would leave its
+ * server busy with a request that never counts down.
+ *
+ * @param path Path of the trace.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the trace is ready to replay.
+ */
+bool TraceReader::open(const std::string& path, std::string& error) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open trace " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < TRACE_HEADER_BYTES) {
+        ::close(fd);
+        error = path + ": not a trace file";
+        return false;
+    }
+
+    mappedBytes = info.st_size;
+    void* map = mmap(nullptr, mappedBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        mappedBytes = 0;
+        error = "cannot map trace " + path;
+        return false;
+    }
+    base = static_cast<const unsigned char*>(map);
+    madvise(map, mappedBytes, MADV_SEQUENTIAL);
+
+    TraceHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        error = path + ": not a trace file";
+    } else if (header.version != TRACE_VERSION || header.recordBytes != TRACE_RECORD_BYTES) {
+        error = path + ": unsupported trace version";
+    } else if (header.count > (mappedBytes - TRACE_HEADER_BYTES) / TRACE_RECORD_BYTES) {
+        error = path + ": truncated trace";
+    } else {
+        records = reinterpret_cast<const TraceRecord*>(base + TRACE_HEADER_BYTES);
+        size_t bad = findBadDuration(records, header.count);
+        if (bad == header.count) {
+            count = header.count;
+            zeroCopy = traceMatchesRequestLayout();
+            return true;
+        }
+        error = path + ": record " + std::to_string(bad) + " has duration "
+            + std::to_string(records[bad].durationAndFlag & TRACE_MAX_DURATION)
+            + "; durations must be between 1 and " + std::to_string(TRACE_MAX_DURATION);
+    }
+    close();
+    return false;
+}
+
+/**
+ * @brief Unmaps the trace.
+ */
+void TraceReader::close() {
+    if (base) {
+        munmap(const_cast<unsigned char*>(base), mappedBytes);
+    }
+    base = nullptr;
+    mappedBytes = 0;
+    records = nullptr;
+    count = 0;
+    position = 0;
+    releasedBytes = 0;
+}
+
+/**
+ * @brief Returns the number of records in the trace.
+ *
+ * @return Record count.
+ */
+size_t TraceReader::size() const {
+    return count;
+}
+
+/**
+ * @brief Returns the number of records not yet replayed.
+ *
+ * @return Remaining record count.
+ */
+size_t TraceReader::remaining() const {
+    return count - position;
+}
+
+/**
+ * @brief Returns the index of the next record to replay.
+ *
+ * @return Number of records already replayed.
+ */
+size_t TraceReader::tell() const {
+    return position;
+}
+
+/**
+ * @brief Continues replay from a record index returned by tell().
+ *
+ * @param index Record index.
+ * @return false if the index is past the end of the trace.
+ */
+bool TraceReader::seek(size_t index) {
+    if (index > count) {
+        return false;
+    }
+    position = index;
+    releasedBytes = 0;
+    return true;
+}
+
+/**
+ * @brief Returns the arrival cycle of the next record.
+ *
+ * @param none Value returned when the trace is exhausted.
+ * @return Arrival cycle of the next record, or none.
+ */
+int TraceReader::nextArrival(int none) const {
+    return position < count ? records[position].arrival : none;
+}
+
+/**
+ * @brief Takes every record that has arrived by a cycle.
+ *
+ * When Request shares the record layout the result points straight
+ * into the mapping; otherwise up to DECODE_BATCH records are decoded
+ * per call and the caller picks up the rest on the next call.
+ *
+ * @param cycle Current clock cycle.
+ * @param first Receives a pointer to the first request.
+ * @return Number of requests taken.
+ */
+size_t TraceReader::takeUntil(int cycle, const Request*& first) {
+    size_t end = position;
+    while (end < count && records[end].arrival <= cycle) {
+        end++;
+    }
+
+    size_t taken = end - position;
+    if (zeroCopy) {
+        first = reinterpret_cast<const Request*>(records + position);
+    } else {
+        taken = std::min(taken, DECODE_BATCH);
+        decoded.resize(taken);
+        for (size_t i = 0; i < taken; i++) {
+            decoded[i] = decodeTraceRecord(records[position + i]);
+        }
+        first = decoded.data();
+    }
+    position += taken;
+    releaseConsumed();
+    return taken;
+}
+
+/**
+ * @brief Tells the kernel it may drop pages that were already replayed.
+ *
+ * Only whole pages behind the previous call's records are released,
+ * since the requests handed out last time may still be in use.
+ */
+void TraceReader::releaseConsumed() {
+    size_t consumed = TRACE_HEADER_BYTES + position * TRACE_RECORD_BYTES;
+    if (consumed - releasedBytes < 2 * RELEASE_BYTES) {
+        return;
+    }
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t upTo = (consumed - RELEASE_BYTES) / page * page;
+    madvise(const_cast<unsigned char*>(base) + releasedBytes, upTo - releasedBytes, MADV_DONTNEED);
+    releasedBytes = upTo;
+}
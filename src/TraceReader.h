@@ -0,0 +1,113 @@
+#ifndef TRACEREADER_H
+#define TRACEREADER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Request.h"
+#include "TraceFormat.h"
+
+/**
+ * @brief Streams requests out of a memory-mapped binary trace.
+ *
+ * The whole file is mapped read-only and consumed front to back, so the
+ * kernel reads ahead and the cost per request is a bounds check and a
+ * copy. Pages already replayed are released periodically, keeping the
+ * resident set small for traces much larger than memory.
+ */
+class TraceReader {
+private:
+    const unsigned char* base;
+    size_t mappedBytes;
+    const TraceRecord* records;
+    size_t count;
+    size_t position;
+    size_t releasedBytes;
+    bool zeroCopy;
+
+    /** Copies of records when Request does not share their layout */
+    std::vector<Request> decoded;
+
+    /**
+     * @brief Tells the kernel it may drop pages that were already replayed.
+     */
+    void releaseConsumed();
+
+public:
+    /**
+     * @brief Constructs a reader with no trace open.
+     */
+    TraceReader();
+
+    /**
+     * @brief Unmaps the trace.
+     */
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    /**
+     * @brief Maps a trace file and validates its header and records.
+     *
+     * @param path Path of the trace
+     * @param error Receives a description of the problem on failure
+     * @return true if the trace is ready to replay
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Unmaps the trace.
+     */
+    void close();
+
+    /**
+     * @brief Returns the number of records in the trace.
+     *
+     * @return Record count
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of records not yet replayed.
+     *
+     * @return Remaining record count
+     */
+    size_t remaining() const;
+
+    /**
+     * @brief Returns the index of the next record to replay.
+     *
+     * @return Number of records already replayed
+     */
+    size_t tell() const;
+
+    /**
+     * @brief Continues replay from a record index returned by tell().
+     *
+     * @param index Record index
+     * @return false if the index is past the end of the trace
+     */
+    bool seek(size_t index);
+
+    /**
+     * @brief Returns the arrival cycle of the next record.
+     *
+     * @param none Value returned when the trace is exhausted
+     * @return Arrival cycle of the next record, or none
+     */
+    int nextArrival(int none) const;
+
+    /**
+     * @brief Takes every record that has arrived by a cycle.
+     *
+     * The returned requests stay valid until the next call.
+     *
+     * @param cycle Current clock cycle
+     * @param first Receives a pointer to the first request
+     * @return Number of requests taken
+     */
+    size_t takeUntil(int cycle, const Request*& first);
+};
+
+#endif // TRACEREADER_H
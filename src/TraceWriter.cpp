@@ -0,0 +1,248 @@
+/**
+ * @file TraceWriter.cpp
+ * @brief Implementation of binary trace writing and CSV conversion.
+ *
+ * This file implements the buffered trace writer and the converter
+ * from CSV traffic captures to the binary trace format.
+ */
+
+#include "TraceWriter.h"
+#include <cstdlib>
+#include <fstream>
+
+/** Records buffered before each write */
+static const size_t WRITE_BATCH = 1 << 16;
+
+/**
+ * @brief Constructs a writer with no file open.
+ */
+TraceWriter::TraceWriter()
+    : file(nullptr),
+      written(0),
+      lastArrival(0)
+{
+}
+
+/**
+ * @brief Closes the file if it is still open.
+ */
+TraceWriter::~TraceWriter() {
+    std::string ignored;
+    close(ignored);
+}
+
+/**
+ * @brief Creates or truncates a trace file.
+ *
+ * Writes a header with a zero record count; close() rewrites it.
+ *
+ * @param path Path of the trace.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the file was created.
+ */
+bool TraceWriter::open(const std::string& path, std::string& error) {
+    std::string ignored;
+    close(ignored);
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create trace " + path;
+        return false;
+    }
+    TraceHeader header = TraceHeader();
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.recordBytes = TRACE_RECORD_BYTES;
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    buffer.clear();
+    buffer.reserve(WRITE_BATCH);
+    written = 0;
+    lastArrival = 0;
+    return true;
+}
+
+/**
+ * @brief Appends one request.
+ *
+ * @param arrival Arrival cycle.
+ * @param ipIn Source address.
+ * @param ipOut Destination address.
+ * @param streaming True for a streaming job.
+ * @param duration Processing time in cycles.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the record was accepted.
+ */
+bool TraceWriter::append(int arrival, uint32_t ipIn, uint32_t ipOut, bool streaming,
+                         int duration, std::string& error) {
+    if (arrival < lastArrival) {
+        error = "arrival " + std::to_string(arrival) + " is earlier than the previous record";
+        return false;
+    }
+    if (duration < 1) {
+        error = "duration must be at least 1";
+        return false;
+    }
+    buffer.push_back(makeTraceRecord(arrival, ipIn, ipOut, streaming, duration));
+    lastArrival = arrival;
+    written++;
+    if (buffer.size() == WRITE_BATCH && !flush()) {
+        error = "write failed";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the buffered records to the file.
+ *
+ * @return true if every record was written.
+ */
+bool TraceWriter::flush() {
+    size_t n = buffer.size();
+    bool ok = std::fwrite(buffer.data(), sizeof(TraceRecord), n, file) == n;
+    buffer.clear();
+    return ok;
+}
+
+/**
+ * @brief Writes the remaining records and the final header.
+ *
+ * @param error Receives a description of the problem on failure.
+ * @return true if the trace is complete.
+ */
+bool TraceWriter::close(std::string& error) {
+    if (!file) {
+        return true;
+    }
+    bool ok = flush();
+    TraceHeader header = TraceHeader();
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.version = TRACE_VERSION;
+    header.recordBytes = TRACE_RECORD_BYTES;
+    header.count = written;
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0
+            && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        error = "write failed";
+    }
+    return ok;
+}
+
+/**
+ * @brief Returns the number of records appended so far.
+ *
+ * @return Record count.
+ */
+uint64_t TraceWriter::size() const {
+    return written;
+}
+
+/**
+ * @brief Splits a CSV line into fields.
+ *
+ * @param line Line to split.
+ * @param fields Receives the fields with surrounding spaces removed.
+ */
+static void splitCsv(const std::string& line, std::vector<std::string>& fields) {
+    fields.clear();
+    size_t start = 0;
+    while (true) {
+        size_t comma = line.find(',', start);
+        std::string field = line.substr(start, comma == std::string::npos ? std::string::npos
+                                                                           : comma - start);
+        size_t first = field.find_first_not_of(" \t\r");
+        size_t last = field.find_last_not_of(" \t\r");
+        fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+        if (comma == std::string::npos) {
+            return;
+        }
+        start = comma + 1;
+    }
+}
+
+/**
+ * @brief Parses a whole string as a non-negative integer below 2^31.
+ *
+ * @param text Text to parse.
+ * @param value Receives the number.
+ * @return true if the text is a valid number.
+ */
+static bool parseCount(const std::string& text, int& value) {
+    char* end = nullptr;
+    long long number = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || number < 0 || number > 2147483647LL) {
+        return false;
+    }
+    value = static_cast<int>(number);
+    return true;
+}
+
+/**
+ * @brief Converts a CSV capture to a binary trace.
+ *
+ * @param csvPath Path of the CSV file.
+ * @param tracePath Path of the trace to write.
+ * @param records Receives the number of records written.
+ * @param error Receives a description of the problem on failure.
+ * @return true if the trace was written.
+ */
+bool convertCsvTrace(const std::string& csvPath, const std::string& tracePath,
+                     uint64_t& records, std::string& error) {
+    std::ifstream in(csvPath);
+    if (!in) {
+        error = "cannot open " + csvPath;
+        return false;
+    }
+    TraceWriter writer;
+    if (!writer.open(tracePath, error)) {
+        return false;
+    }
+
+    std::string line;
+    std::vector<std::string> fields;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        if (lineNumber == 1 && !(line[0] >= '0' && line[0] <= '9')) {
+            continue;
+        }
+
+        std::string where = csvPath + ":" + std::to_string(lineNumber) + ": ";
+        splitCsv(line, fields);
+        int arrival;
+        int duration;
+        uint32_t ipIn;
+        uint32_t ipOut;
+        bool streaming;
+        if (fields.size() != 5) {
+            error = where + "expected 5 fields";
+            return false;
+        }
+        if (!parseCount(fields[0], arrival) || !parseIP(fields[1], ipIn)
+            || !parseIP(fields[2], ipOut) || !parseCount(fields[4], duration)) {
+            error = where + "malformed record";
+            return false;
+        }
+        if (fields[3] == "1" || fields[3] == "true") {
+            streaming = true;
+        } else if (fields[3] == "0" || fields[3] == "false") {
+            streaming = false;
+        } else {
+            error = where + "streaming must be 0/1 or true/false";
+            return false;
+        }
+        if (!writer.append(arrival, ipIn, ipOut, streaming, duration, error)) {
+            error = where + error;
+            return false;
+        }
+    }
+
+    records = writer.size();
+    return writer.close(error);
+}
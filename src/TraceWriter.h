@@ -0,0 +1,100 @@
+#ifndef TRACEWRITER_H
+#define TRACEWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "TraceFormat.h"
+
+/**
+ * @brief Writes a binary request trace.
+ *
+ * Records are buffered and written in large blocks. The record count in
+ * the header is filled in by close(), so a trace whose writer was not
+ * closed is rejected by TraceReader as truncated or empty.
+ */
+class TraceWriter {
+private:
+    std::FILE* file;
+    std::vector<TraceRecord> buffer;
+    uint64_t written;
+    int lastArrival;
+
+    /**
+     * @brief Writes the buffered records to the file.
+     */
+    bool flush();
+
+public:
+    /**
+     * @brief Constructs a writer with no file open.
+     */
+    TraceWriter();
+
+    /**
+     * @brief Closes the file if it is still open.
+     */
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /**
+     * @brief Creates or truncates a trace file.
+     *
+     * @param path Path of the trace
+     * @param error Receives a description of the problem on failure
+     * @return true if the file was created
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Appends one request.
+     *
+     * @param arrival Arrival cycle; must not be earlier than the previous record's
+     * @param ipIn Source address (packed IPv4)
+     * @param ipOut Destination address (packed IPv4)
+     * @param streaming True for a streaming job
+     * @param duration Processing time in cycles, at least 1
+     * @param error Receives a description of the problem on failure
+     * @return true if the record was accepted
+     */
+    bool append(int arrival, uint32_t ipIn, uint32_t ipOut, bool streaming, int duration,
+                std::string& error);
+
+    /**
+     * @brief Writes the remaining records and the final header.
+     *
+     * @param error Receives a description of the problem on failure
+     * @return true if the trace is complete
+     */
+    bool close(std::string& error);
+
+    /**
+     * @brief Returns the number of records appended so far.
+     *
+     * @return Record count
+     */
+    uint64_t size() const;
+};
+
+/**
+ * @brief Converts a CSV capture to a binary trace.
+ *
+ * Each line is "arrival,ip_in,ip_out,streaming,duration" with dotted-quad
+ * addresses and streaming given as 0/1 or true/false. A first line that
+ * does not start with a digit is treated as a column header; blank lines
+ * are skipped. Lines must be sorted by arrival cycle.
+ *
+ * @param csvPath Path of the CSV file
+ * @param tracePath Path of the trace to write
+ * @param records Receives the number of records written
+ * @param error Receives a description of the problem on failure
+ * @return true if the trace was written
+ */
+bool convertCsvTrace(const std::string& csvPath, const std::string& tracePath,
+                     uint64_t& records, std::string& error);
+
+#endif // TRACEWRITER_H
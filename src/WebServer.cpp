@@ -1,75 +1,220 @@
 #include "WebServer.h"
+#include "ServerPool.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
 
 /**
- * @brief Constructs a WebServer with a unique server ID.
+ * @brief Constructs a handle to one server of a pool.
  *
- * The server is initialized in an available (idle) state with
- * no active request and zero remaining processing time.
- *
- * @param id Unique identifier for the web server.
+ * @param pool Pool that owns the server's state.
+ * @param index Slot of the server in the pool.
  */
-WebServer::WebServer(int id)
-    : serverID(id),
-      isAvailable(true),
-      currentRequest("", "", false, 0, 0),
-      timeRemaining(0)
+WebServer::WebServer(ServerPool& pool, size_t index)
+    : pool(&pool),
+      index(index)
 {
 }
 
 /**
- * @brief Checks whether the web server is currently available.
+ * @brief Checks whether the server is running nothing.
  *
- * @return true if the server is idle and can accept a request,
- *         false if it is currently processing a request.
+ * @return true if every lane is idle.
  */
 bool WebServer::isNotActive() const {
-    return isAvailable;
+    return freeLanes() == laneCount();
+}
+
+/**
+ * @brief Returns the number of requests the server runs at once.
+ *
+ * @return Lane count.
+ */
+size_t WebServer::laneCount() const {
+    return pool->firstLane[index + 1] - pool->firstLane[index];
+}
+
+/**
+ * @brief Returns the server's first lane; its lanes are consecutive.
+ *
+ * @return Lane index in the pool.
+ */
+size_t WebServer::getFirstLane() const {
+    return pool->firstLane[index];
+}
+
+/**
+ * @brief Returns the number of idle lanes.
+ *
+ * @return Lanes that can start a request now.
+ */
+size_t WebServer::freeLanes() const {
+    size_t free = 0;
+    for (size_t lane = pool->firstLane[index]; lane < pool->firstLane[index + 1]; lane++) {
+        free += pool->remaining[lane] == 0;
+    }
+    return free;
 }
 
 /**
- * @brief Assigns a request to the web server for processing.
+ * @brief Starts a request on the lowest idle lane.
  *
- * The server becomes unavailable until the request has completed.
- * The remaining processing time is initialized based on the request.
+ * The lane becomes unavailable until the request has completed.
+ * Its remaining processing time is the request's processing time
+ * scaled by the server's speed.
  *
  * @param request The Request object to be processed.
+ * @return Lane the request runs on.
  */
-void WebServer::processRequest(const Request& request) {
-    currentRequest = request;
-    timeRemaining = request.getProcessingTime();
-    isAvailable = false;
+size_t WebServer::processRequest(const Request& request) {
+    size_t lane = pool->firstLane[index];
+    while (pool->remaining[lane] != 0) {
+        lane++;
+    }
+    pool->current[lane] = request;
+    pool->remaining[lane] = serviceTime(request);
+    return lane;
 }
 
 /**
  * @brief Advances request processing by one clock cycle.
  *
- * Decrements the remaining processing time if the server is busy.
- * When processing completes, the server becomes available again.
+ * Decrements the remaining processing time of every busy lane.
+ * The pool's tick() does the same for every server at once.
  */
 void WebServer::handleRequest() {
-    if (!isAvailable && timeRemaining > 0) {
-        timeRemaining--;
-
-        if (timeRemaining == 0) {
-            isAvailable = true;
+    for (size_t lane = pool->firstLane[index]; lane < pool->firstLane[index + 1]; lane++) {
+        if (pool->remaining[lane] > 0) {
+            pool->remaining[lane]--;
         }
     }
 }
 
 /**
- * @brief Returns the request currently being processed.
+ * @brief Completes a lane's request immediately.
+ *
+ * @param lane Lane to complete.
+ */
+void WebServer::finishRequest(size_t lane) {
+    pool->remaining[lane] = 0;
+}
+
+/**
+ * @brief Returns the slab entry of one position in the local queue.
+ *
+ * @param position Index in the ring, at most twice the capacity.
+ * @return Request stored there.
+ */
+Request& WebServer::queued(size_t position) const {
+    size_t capacity = pool->queueCapacity;
+    if (position >= capacity) {
+        position -= capacity;
+    }
+    return pool->waiting[index * capacity + position];
+}
+
+/**
+ * @brief Queues a request behind the ones being processed.
+ *
+ * @param request The request to queue.
+ */
+void WebServer::enqueue(const Request& request) {
+    queued(pool->queueHead[index] + pool->queueSize[index]) = request;
+    pool->queueSize[index]++;
+}
+
+/**
+ * @brief Starts the next locally queued request if a lane is idle.
+ *
+ * @return Lane the request was started on, or NO_LANE.
+ */
+size_t WebServer::startQueued() {
+    if (pool->queueSize[index] == 0 || freeLanes() == 0) {
+        return NO_LANE;
+    }
+    uint32_t& head = pool->queueHead[index];
+    size_t lane = processRequest(queued(head));
+    head = head + 1 == pool->queueCapacity ? 0 : head + 1;
+    pool->queueSize[index]--;
+    return lane;
+}
+
+/**
+ * @brief Moves every locally queued request to another queue.
+ *
+ * @param destination Queue receiving the requests in order.
+ * @return Number of requests moved.
+ */
+size_t WebServer::moveQueuedTo(RingBuffer<Request>& destination) {
+    size_t moved = pool->queueSize[index];
+    for (size_t q = 0; q < moved; q++) {
+        destination.push(queued(pool->queueHead[index] + q));
+    }
+    pool->queueHead[index] = 0;
+    pool->queueSize[index] = 0;
+    return moved;
+}
+
+/**
+ * @brief Returns the number of requests waiting in the local queue.
+ *
+ * @return Local queue length.
+ */
+size_t WebServer::queuedCount() const {
+    return pool->queueSize[index];
+}
+
+/**
+ * @brief Returns the server's relative capacity.
+ *
+ * @return Weight used by weighted dispatch.
+ */
+double WebServer::getWeight() const {
+    return pool->weights[index];
+}
+
+/**
+ * @brief Returns the server's processing speed.
+ *
+ * @return Work units completed per clock cycle.
+ */
+double WebServer::getSpeed() const {
+    return pool->speeds[index];
+}
+
+/**
+ * @brief Returns how many cycles this server needs for a request.
+ *
+ * @param request Request to time.
+ * @return Processing time divided by the speed, rounded up, at least 1;
+ *         INT_MAX for a server too slow to ever finish it.
+ */
+int WebServer::serviceTime(const Request& request) const {
+    double speed = pool->speeds[index];
+    if (speed == 1.0) {
+        return request.getProcessingTime();
+    }
+    // Clamped in double first: casting a quotient past INT_MAX is undefined
+    double cycles = std::min(std::ceil(request.getProcessingTime() / speed), static_cast<double>(INT_MAX));
+    return std::max(1, static_cast<int>(cycles));
+}
+
+/**
+ * @brief Returns the request a lane is processing.
  *
- * @return The active Request object.
+ * @param lane Lane of this server.
+ * @return The lane's current (or last) Request.
  */
-Request WebServer::getCurrentRequest() const {
-    return currentRequest;
+const Request& WebServer::getRequest(size_t lane) const {
+    return pool->current[lane];
 }
 
 /**
- * @brief Gets the remaining processing time for the current request.
+ * @brief Returns a lane's remaining processing time.
  *
+ * @param lane Lane of this server.
  * @return Number of clock cycles remaining.
  */
-int WebServer::getTimeRemaining() const {
-    return timeRemaining;
+int WebServer::getTimeRemaining(size_t lane) const {
+    return pool->remaining[lane];
 }
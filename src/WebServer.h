@@ -1,64 +1,173 @@
 #ifndef WEBSERVER_H
 #define WEBSERVER_H
 
+#include <cstddef>
 #include "Request.h"
+#include "RingBuffer.h"
+
+class ServerPool;
 
 /**
  * @brief Represents a single web server in the load balancer system.
  *
- * A WebServer processes one request at a time. It tracks availability,
- * remaining processing time, and the current request being handled.
+ * A WebServer processes up to a fixed number of requests at once, one
+ * per lane. It tracks how many lanes are free, the remaining processing
+ * time of each lane and the request each lane is handling. Requests
+ * assigned while every lane is busy wait in its own local queue.
+ *
+ * The state itself lives in a ServerPool, stored as parallel arrays so
+ * the pool can tick every lane with one vectorized pass. A WebServer
+ * is a small handle to one slot of that pool; copies refer to the same
+ * server. Lanes are identified by their index in the pool.
  */
 class WebServer {
 private:
-    int serverID;
-    bool isAvailable;
-    Request currentRequest;
-    int timeRemaining;
+    ServerPool* pool;
+    size_t index;
+
+    /**
+     * @brief Returns the slab entry of one position in the local queue.
+     *
+     * @param position Index in the ring, at most twice the capacity
+     * @return Request stored there
+     */
+    Request& queued(size_t position) const;
 
 public:
+    /** Returned by startQueued() when no request was started */
+    static const size_t NO_LANE = static_cast<size_t>(-1);
+
     /**
-     * @brief Constructs a WebServer with a given ID.
+     * @brief Constructs a handle to one server of a pool.
      *
-     * @param id Unique identifier for the server
+     * @param pool Pool that owns the server's state
+     * @param index Slot of the server in the pool
      */
-    WebServer(int serverID);
+    WebServer(ServerPool& pool, size_t index);
 
     /**
-     * @brief Checks whether the server is available.
+     * @brief Checks whether the server is running nothing.
      *
-     * @return true if the server is idle
+     * @return true if every lane is idle
      */
     bool isNotActive() const;
 
     /**
-     * @brief Assigns a request to the server for processing.
+     * @brief Returns the number of requests the server runs at once.
+     *
+     * @return Lane count
+     */
+    size_t laneCount() const;
+
+    /**
+     * @brief Returns the server's first lane; its lanes are consecutive.
+     *
+     * @return Lane index in the pool
+     */
+    size_t getFirstLane() const;
+
+    /**
+     * @brief Returns the number of idle lanes.
+     *
+     * @return Lanes that can start a request now
+     */
+    size_t freeLanes() const;
+
+    /**
+     * @brief Starts a request on the lowest idle lane.
+     *
+     * The server must have a free lane.
      *
      * @param request The request to process
+     * @return Lane the request runs on
      */
-    void processRequest(const Request& request);
+    size_t processRequest(const Request& request);
 
     /**
      * @brief Processes one clock cycle.
      *
-     * Decrements remaining processing time and frees the server
-     * when the request finishes.
+     * Decrements the remaining processing time of every busy lane.
      */
     void handleRequest();
 
     /**
-     * @brief Returns the request currently being processed.
+     * @brief Completes a lane's request immediately.
+     *
+     * Used by the event-driven scheduler, which knows the completion
+     * cycle up front and does not tick servers one cycle at a time.
+     *
+     * @param lane Lane to complete
+     */
+    void finishRequest(size_t lane);
+
+    /**
+     * @brief Queues a request behind the ones being processed.
+     *
+     * The local queue must have room; its capacity is fixed by the pool.
+     *
+     * @param request The request to queue
+     */
+    void enqueue(const Request& request);
+
+    /**
+     * @brief Starts the next locally queued request if a lane is idle.
+     *
+     * @return Lane the request was started on, or NO_LANE
+     */
+    size_t startQueued();
+
+    /**
+     * @brief Moves every locally queued request to another queue.
+     *
+     * @param destination Queue receiving the requests in order
+     * @return Number of requests moved
+     */
+    size_t moveQueuedTo(RingBuffer<Request>& destination);
+
+    /**
+     * @brief Returns the number of requests waiting in the local queue.
+     *
+     * @return Local queue length
+     */
+    size_t queuedCount() const;
+
+    /**
+     * @brief Returns the server's relative capacity.
+     *
+     * @return Weight used by weighted dispatch
+     */
+    double getWeight() const;
+
+    /**
+     * @brief Returns the server's processing speed.
+     *
+     * @return Work units completed per clock cycle
+     */
+    double getSpeed() const;
+
+    /**
+     * @brief Returns how many cycles this server needs for a request.
+     *
+     * @param request Request to time
+     * @return Processing time divided by the speed, rounded up, at least 1
+     */
+    int serviceTime(const Request& request) const;
+
+    /**
+     * @brief Returns the request a lane is processing.
      *
-     * @return The active Request
+     * @param lane Lane of this server
+     * @return The lane's current (or last) Request
      */
-    Request getCurrentRequest() const;
+    const Request& getRequest(size_t lane) const;
 
     /**
-     * @brief Returns remaining processing time.
+     * @brief Returns a lane's remaining processing time.
      *
+     * @param lane Lane of this server
      * @return Time remaining in clock cycles
      */
-    int getTimeRemaining() const;
+    int getTimeRemaining(size_t lane) const;
 };
 
 #endif // WEBSERVER_H
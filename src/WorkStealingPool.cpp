@@ -0,0 +1,157 @@
+/**
+ * @file WorkStealingPool.cpp
+ * @brief Implementation of the work-stealing thread pool.
+ *
+ * This file implements task submission, per-worker deques and
+ * stealing between workers.
+ */
+
+#include "WorkStealingPool.h"
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * @param numThreads Number of workers; 0 uses the hardware concurrency.
+ */
+WorkStealingPool::WorkStealingPool(size_t numThreads)
+    : outstanding(0),
+      queued(0),
+      nextQueue(0),
+      stopping(false)
+{
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();
+    }
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+
+    for (size_t i = 0; i < numThreads; i++) {
+        queues.emplace_back(new WorkQueue());
+    }
+    for (size_t i = 0; i < numThreads; i++) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Waits for queued tasks to finish and joins the workers.
+ */
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Queues a task.
+ *
+ * @param task Callable run once on some worker.
+ */
+void WorkStealingPool::submit(std::function<void()> task) {
+    size_t target;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        outstanding++;
+        queued++;
+        target = nextQueue;
+        nextQueue = (nextQueue + 1) % queues.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+/**
+ * @brief Takes a task from a worker's own queue or steals one.
+ *
+ * The worker's own queue is used LIFO for locality; victims are
+ * robbed FIFO so the oldest, typically largest, work moves first.
+ *
+ * @param self Index of the calling worker.
+ * @param task Receives the task.
+ * @return true if a task was found.
+ */
+bool WorkStealingPool::takeTask(size_t self, std::function<void()>& task) {
+    {
+        WorkQueue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkQueue& victim = *queues[(self + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ *
+ * Runs tasks while any can be found, then sleeps until more are
+ * submitted or the pool shuts down.
+ *
+ * @param self Index of this worker.
+ */
+void WorkStealingPool::workerLoop(size_t self) {
+    std::function<void()> task;
+    while (true) {
+        if (takeTask(self, task)) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                queued--;
+            }
+            task();
+            task = nullptr;
+
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--outstanding == 0) {
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        // queued is raised before the task is pushed, so a worker woken
+        // early simply rescans until the push lands
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Blocks until every submitted task has finished.
+ */
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return outstanding == 0; });
+}
+
+/**
+ * @brief Returns the number of worker threads.
+ *
+ * @return Worker count.
+ */
+size_t WorkStealingPool::size() const {
+    return workers.size();
+}
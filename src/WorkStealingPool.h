@@ -0,0 +1,99 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size thread pool with per-worker work-stealing queues.
+ *
+ * Tasks are dealt round-robin onto per-worker deques. A worker takes
+ * tasks from the back of its own deque and, when that runs dry, steals
+ * from the front of another worker's deque, so long and short tasks
+ * balance out without a single shared queue.
+ */
+class WorkStealingPool {
+private:
+    /** One worker's task deque */
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+
+    /** Tasks submitted but not yet finished */
+    size_t outstanding;
+
+    /** Tasks submitted but not yet taken by a worker */
+    size_t queued;
+
+    /** Queue that receives the next submitted task */
+    size_t nextQueue;
+
+    bool stopping;
+
+    /**
+     * @brief Takes a task from a worker's own queue or steals one.
+     *
+     * @param self Index of the calling worker
+     * @param task Receives the task
+     * @return true if a task was found
+     */
+    bool takeTask(size_t self, std::function<void()>& task);
+
+    /**
+     * @brief Main loop of a worker thread.
+     *
+     * @param self Index of this worker
+     */
+    void workerLoop(size_t self);
+
+public:
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param numThreads Number of workers; 0 uses the hardware concurrency
+     */
+    explicit WorkStealingPool(size_t numThreads);
+
+    /**
+     * @brief Waits for queued tasks to finish and joins the workers.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queues a task.
+     *
+     * @param task Callable run once on some worker
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     */
+    void wait();
+
+    /**
+     * @brief Returns the number of worker threads.
+     *
+     * @return Worker count
+     */
+    size_t size() const;
+};
+
+#endif // WORKSTEALINGPOOL_H
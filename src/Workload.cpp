@@ -0,0 +1,201 @@
+/**
+ * @file Workload.cpp
+ * @brief Implementation of the arrival and duration models.
+ *
+ * This file implements the per-cycle arrival counts of each model,
+ * request generation and the Poisson sampler the models share.
+ */
+
+#include "Workload.h"
+
+/** Mean below which Poisson counts are drawn by inversion */
+static const double INVERSION_LIMIT = 10.0;
+
+/**
+ * @brief Constructs the workload a configuration describes.
+ *
+ * @param config Validated configuration.
+ */
+Workload::Workload(const SimConfig& config)
+    : model(Model::Bernoulli),
+      probability(config.arrivalProbability),
+      rate(config.arrivalRate),
+      amplitude(config.diurnalAmplitude),
+      radiansPerCycle(2.0 * M_PI / config.diurnalPeriod),
+      stateRates(config.mmppRates),
+      currentState(0),
+      pareto(config.durations == "pareto"),
+      negInvShape(-1.0 / config.paretoShape),
+      durationCap(config.durationCap),
+      streamMin(config.streamMin),
+      streamSpan(config.streamMax - config.streamMin + 1),
+      procMin(config.procMin),
+      procSpan(config.procMax - config.procMin + 1),
+      clients(static_cast<uint32_t>(config.clients))
+{
+    if (config.workload == "poisson") {
+        model = Model::Poisson;
+    } else if (config.workload == "diurnal") {
+        model = Model::Diurnal;
+    } else if (config.workload == "mmpp") {
+        model = Model::Mmpp;
+    }
+    for (size_t s = 0; s < config.mmppDwell.size(); s++) {
+        leaveProbability.push_back(1.0 / config.mmppDwell[s]);
+    }
+}
+
+/**
+ * @brief Draws the number of requests arriving on a cycle.
+ *
+ * The Bernoulli model takes exactly one draw per cycle, as the original
+ * simulation did. An MMPP first decides whether to leave its state,
+ * moving to one of the others at random, and then draws from the mean
+ * of the state it is in.
+ *
+ * @param cycle The cycle after the one of the previous call.
+ * @param rng Random generator.
+ * @return Number of arrivals.
+ */
+size_t Workload::arrivals(int cycle, Random& rng) {
+    switch (model) {
+    case Model::Bernoulli:
+        return rng.nextDouble() < probability ? 1 : 0;
+    case Model::Mmpp:
+        if (stateRates.size() > 1 && rng.nextDouble() < leaveProbability[currentState]) {
+            uint32_t others = static_cast<uint32_t>(stateRates.size() - 1);
+            currentState = (currentState + 1 + rng.uniform(others)) % stateRates.size();
+        }
+        break;
+    default:
+        break;
+    }
+    return static_cast<size_t>(poisson(meanArrivals(cycle), rng));
+}
+
+/**
+ * @brief Returns the mean number of arrivals on a cycle.
+ *
+ * @param cycle Clock cycle.
+ * @return Mean arrivals.
+ */
+double Workload::meanArrivals(int cycle) const {
+    switch (model) {
+    case Model::Bernoulli:
+        return probability;
+    case Model::Poisson:
+        return rate;
+    case Model::Diurnal:
+        return rate * (1.0 + amplitude * std::sin(radiansPerCycle * cycle));
+    case Model::Mmpp:
+        return stateRates[currentState];
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Fills a block of random requests arriving on a cycle.
+ *
+ * Each request takes two 64-bit draws: the first supplies both IP
+ * addresses, the second the job type (top bit) and, from its low 32
+ * bits, a processing time from the duration model. With a client
+ * population the source address bits pick a client instead, whose
+ * address is its index times an odd constant, so distinct clients
+ * never share one.
+ *
+ * @param out Destination array with room for n requests.
+ * @param n Number of requests to generate.
+ * @param cycle Arrival cycle of every request.
+ * @param rng Random generator.
+ */
+void Workload::generate(Request* out, size_t n, int cycle, Random& rng) const {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t ips = rng.next();
+        uint64_t job = rng.next();
+
+        uint32_t source = static_cast<uint32_t>(ips >> 32);
+        if (clients > 0) {
+            source = static_cast<uint32_t>((static_cast<uint64_t>(source) * clients) >> 32) * 0x9E3779B1u;
+        }
+        bool isStreaming = (job >> 63) != 0;
+        out[i] = Request(source, static_cast<uint32_t>(ips),
+                         isStreaming, duration(isStreaming, static_cast<uint32_t>(job)), cycle);
+    }
+}
+
+/**
+ * @brief Returns the MMPP state, for checkpoints.
+ *
+ * @return Current state index.
+ */
+uint32_t Workload::state() const {
+    return currentState;
+}
+
+/**
+ * @brief Restores a state returned by state().
+ *
+ * @param index State index.
+ * @return false if the model has no such state.
+ */
+bool Workload::setState(uint32_t index) {
+    if (index != 0 && (model != Model::Mmpp || index >= stateRates.size())) {
+        return false;
+    }
+    currentState = index;
+    return true;
+}
+
+/**
+ * @brief Draws a Poisson distributed count.
+ *
+ * Small means walk the cumulative distribution from zero, which takes
+ * mean + 1 steps on average. Larger means use PTRS (W. Hormann, "The
+ * transformed rejection method for generating Poisson random variables",
+ * 1993): a cheap hat function accepts about 90% of candidates without
+ * any further work, and the rest are settled against the exact mass.
+ *
+ * @param mean Distribution mean.
+ * @param rng Random generator.
+ * @return Count.
+ */
+uint64_t Workload::poisson(double mean, Random& rng) {
+    if (mean <= 0.0) {
+        return 0;
+    }
+    if (mean < INVERSION_LIMIT) {
+        double u = rng.nextDouble();
+        double mass = std::exp(-mean);
+        double cumulative = mass;
+        uint64_t k = 0;
+        while (u > cumulative && mass > 0.0) {
+            k++;
+            mass *= mean / k;
+            cumulative += mass;
+        }
+        return k;
+    }
+
+    double rootMean = std::sqrt(mean);
+    double logMean = std::log(mean);
+    double b = 0.931 + 2.53 * rootMean;
+    double a = -0.059 + 0.02483 * b;
+    double invAlpha = 1.1239 + 1.1328 / (b - 3.4);
+    double vr = 0.9277 - 3.6224 / (b - 2.0);
+    while (true) {
+        double u = rng.nextDouble() - 0.5;
+        double v = rng.nextDouble();
+        double us = 0.5 - std::fabs(u);
+        double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+        if (us >= 0.07 && v <= vr) {
+            return static_cast<uint64_t>(k);
+        }
+        if (k < 0.0 || (us < 0.013 && v > us)) {
+            continue;
+        }
+        if (std::log(v) + std::log(invAlpha) - std::log(a / (us * us) + b)
+            <= -mean + k * logMean - std::lgamma(k + 1.0)) {
+            return static_cast<uint64_t>(k);
+        }
+    }
+}
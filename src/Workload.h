@@ -0,0 +1,163 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Random.h"
+#include "Request.h"
+#include "SimConfig.h"
+
+/**
+ * @brief Generates how many requests arrive on each cycle and how long
+ *        each one runs.
+ *
+ * Arrival models:
+ *   - bernoulli: at most one request per cycle, with a fixed probability
+ *     (the original model)
+ *   - poisson:   a Poisson number of requests with a fixed mean
+ *   - diurnal:   Poisson with a mean that follows a sinusoid, for daily
+ *                peaks and troughs
+ *   - mmpp:      Markov-modulated Poisson; a hidden state with its own
+ *                mean changes at random, which produces bursts
+ *
+ * Every model draws the whole count for a cycle at once, in constant
+ * time however large the mean, so the requests themselves can be made
+ * in one batch. Durations are either uniform over each job type's range
+ * or Pareto distributed with the range minimum as scale, for heavy
+ * tails. Source addresses are random, or drawn from a fixed population
+ * of clients so that the same addresses recur.
+ *
+ * arrivals() must be called once for every cycle, in order, since the
+ * MMPP state advances with each call.
+ */
+class Workload {
+public:
+    /**
+     * @brief Arrival models.
+     */
+    enum class Model {
+        Bernoulli,
+        Poisson,
+        Diurnal,
+        Mmpp
+    };
+
+private:
+    Model model;
+    double probability;
+    double rate;
+    double amplitude;
+    double radiansPerCycle;
+
+    /** MMPP: mean arrivals and per-cycle leaving probability of each state */
+    std::vector<double> stateRates;
+    std::vector<double> leaveProbability;
+    uint32_t currentState;
+
+    bool pareto;
+    double negInvShape;
+    int durationCap;
+    int streamMin;
+    int streamSpan;
+    int procMin;
+    int procSpan;
+    uint32_t clients;
+
+    /**
+     * @brief Draws a Pareto duration.
+     *
+     * @param minimum Smallest duration, the distribution's scale
+     * @param bits Uniform random bits
+     * @return Duration in cycles, at most durationCap
+     */
+    int paretoDuration(int minimum, uint32_t bits) const {
+        double u = (static_cast<double>(bits) + 0.5) * 0x1.0p-32;
+        double value = minimum * std::exp(std::log(u) * negInvShape);
+        return value < durationCap ? static_cast<int>(value) : durationCap;
+    }
+
+public:
+    /**
+     * @brief Constructs the workload a configuration describes.
+     *
+     * @param config Validated configuration
+     */
+    explicit Workload(const SimConfig& config);
+
+    /**
+     * @brief Draws the number of requests arriving on a cycle.
+     *
+     * @param cycle The cycle after the one of the previous call
+     * @param rng Random generator
+     * @return Number of arrivals
+     */
+    size_t arrivals(int cycle, Random& rng);
+
+    /**
+     * @brief Returns the mean number of arrivals on a cycle.
+     *
+     * For MMPP this is the mean of the current state.
+     *
+     * @param cycle Clock cycle
+     * @return Mean arrivals
+     */
+    double meanArrivals(int cycle) const;
+
+    /**
+     * @brief Returns the processing time of a request.
+     *
+     * @param streaming True for a streaming job
+     * @param bits Uniform random bits
+     * @return Processing time in cycles
+     */
+    int duration(bool streaming, uint32_t bits) const {
+        int minimum = streaming ? streamMin : procMin;
+        if (pareto) {
+            return paretoDuration(minimum, bits);
+        }
+        int span = streaming ? streamSpan : procSpan;
+        return minimum + static_cast<int>((static_cast<uint64_t>(bits) * span) >> 32);
+    }
+
+    /**
+     * @brief Fills a block of random requests arriving on a cycle.
+     *
+     * @param out Destination array with room for n requests
+     * @param n Number of requests to generate
+     * @param cycle Arrival cycle of every request
+     * @param rng Random generator
+     */
+    void generate(Request* out, size_t n, int cycle, Random& rng) const;
+
+    /**
+     * @brief Returns the MMPP state, for checkpoints.
+     *
+     * @return Current state index; 0 for the other models
+     */
+    uint32_t state() const;
+
+    /**
+     * @brief Restores a state returned by state().
+     *
+     * @param index State index
+     * @return false if the model has no such state
+     */
+    bool setState(uint32_t index);
+
+    /**
+     * @brief Draws a Poisson distributed count.
+     *
+     * Means below 10 use inversion; larger means use Hormann's PTRS
+     * transformed rejection, which takes about 1.1 pairs of uniforms
+     * per draw at any mean.
+     *
+     * @param mean Distribution mean, at least 0
+     * @param rng Random generator
+     * @return Count
+     */
+    static uint64_t poisson(double mean, Random& rng);
+};
+
+#endif // WORKLOAD_H
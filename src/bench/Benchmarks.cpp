@@ -0,0 +1,575 @@
+/**
+ * @file Benchmarks.cpp
+ * @brief Google Benchmark suite for the simulation's hot paths.
+ *
+ * Micro benchmarks cover request generation, arrival counts, blocklist
+ * lookups, sticky flow lookups, the request queue and its in-place
+ * drain, multi-producer ingress, the per-cycle server tick, dispatch and
+ * the allocations made by a run. Macro benchmarks run
+ * whole simulations at 10, 1k and 100k servers and report simulated
+ * cycles and processed requests per second. Run with
+ * `make bench`, which writes the results as JSON for comparison
+ * between builds.
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Blocklist.h"
+#include "../DispatchPolicy.h"
+#include "../FlowTable.h"
+#include "../IdleServerSet.h"
+#include "../LoadBalancer.h"
+#include "../MpmcQueue.h"
+#include "../Random.h"
+#include "../Request.h"
+#include "../RingBuffer.h"
+#include "../ServerPool.h"
+#include "../SimConfig.h"
+#include "../WebServer.h"
+#include "../Workload.h"
+
+/**
+ * Calls to the global operator new made by this thread, for
+ * BM_RunAllocations. Counted per thread so the log writer thread, which
+ * allocates its buffer whenever it happens to start, is left out.
+ */
+static thread_local uint64_t allocationCount = 0;
+
+// Kept out of line: once inlined, GCC pairs the malloc and free below
+// with new and delete expressions and warns that they do not match
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief Returns a run configuration that logs nothing.
+ *
+ * @param servers Initial number of servers
+ * @param cycles Clock cycles to simulate
+ * @return Default configuration with logging off
+ */
+static SimConfig quietConfig(int servers, int cycles) {
+    SimConfig config;
+    config.servers = servers;
+    config.cycles = cycles;
+    config.seed = 1;
+    config.progress = false;
+    config.logPath = "/dev/null";
+    config.logLevel = LogLevel::Quiet;
+    return config;
+}
+
+/**
+ * @brief Builds a request whose fields depend on i.
+ */
+static Request makeRequest(size_t i) {
+    return Request(static_cast<uint32_t>(i * 2654435761u),
+                   static_cast<uint32_t>(i), i & 1, 12 + i % 29,
+                   static_cast<int>(i));
+}
+
+/**
+ * @brief One random request per iteration.
+ */
+static void BM_GenRandReq(benchmark::State& state) {
+    LoadBalancer lb(quietConfig(1, 1));
+    lb.setConsole(nullptr);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lb.genRandReq());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenRandReq);
+
+/**
+ * @brief Random requests generated 64 at a time.
+ */
+static void BM_GenRandReqBatch(benchmark::State& state) {
+    LoadBalancer lb(quietConfig(1, 1));
+    lb.setConsole(nullptr);
+    Request batch[64];
+    for (auto _ : state) {
+        lb.genRandReqBatch(batch, 64);
+        benchmark::DoNotOptimize(batch);
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_GenRandReqBatch);
+
+/**
+ * @brief One Poisson arrival count with mean N per iteration.
+ */
+static void BM_PoissonArrivals(benchmark::State& state) {
+    Random rng(3);
+    double mean = static_cast<double>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Workload::poisson(mean, rng));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PoissonArrivals)->Arg(1)->Arg(100)->Arg(10000);
+
+/**
+ * @brief Blocklist lookups of random addresses against N ranges.
+ *
+ * With one range this is the default 192.0.0.0-200.255.255.255 block.
+ */
+static void BM_BlocklistContains(benchmark::State& state) {
+    Blocklist blocklist;
+    Random rng(2);
+    if (state.range(0) == 1) {
+        blocklist.addRange(192u << 24, (201u << 24) - 1);
+    }
+    for (int64_t i = 0; state.range(0) > 1 && i < state.range(0); i++) {
+        uint32_t first = static_cast<uint32_t>(rng.next() >> 32);
+        blocklist.addRange(first, first + 255 < first ? ~0u : first + 255);
+    }
+    blocklist.compile();
+
+    std::vector<uint32_t> ips(4096);
+    for (uint32_t& ip : ips) {
+        ip = static_cast<uint32_t>(rng.next() >> 32);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(blocklist.contains(ips[i++ & 4095]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BlocklistContains)->Arg(1)->Arg(1000)->Arg(100000);
+
+/**
+ * @brief Flow table lookups of N recurring clients, pinning the misses.
+ *
+ * The table holds 65536 flows, so the larger client counts measure
+ * eviction as well as lookup.
+ */
+static void BM_FlowTableFind(benchmark::State& state) {
+    FlowTable flows(65536, 1000);
+    Random rng(4);
+    uint32_t clients = static_cast<uint32_t>(state.range(0));
+    uint32_t i = 0;
+    int now = 1;
+    for (auto _ : state) {
+        uint32_t ip = rng.uniform(clients) * 0x9E3779B1u;
+        FlowTable::Flow* flow = flows.find(ip, now);
+        if (!flow) {
+            flows.insert(ip, i, 0, now);
+        }
+        benchmark::DoNotOptimize(flow);
+        now += (++i & 63) == 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FlowTableFind)->Arg(1000)->Arg(1000000);
+
+/**
+ * @brief One push and one pop against a standing backlog.
+ */
+static void BM_QueuePushPop(benchmark::State& state) {
+    RingBuffer<Request> queue;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        queue.push(makeRequest(i));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        queue.push(makeRequest(i++));
+        benchmark::DoNotOptimize(queue.front().getIpIn());
+        queue.pop();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueuePushPop)->Arg(200)->Arg(100000);
+
+/**
+ * @brief Pushes 64 requests with pushBatch() and pops them with popBatch().
+ */
+static void BM_QueueBatch(benchmark::State& state) {
+    RingBuffer<Request> queue;
+    Request batch[64];
+    for (size_t i = 0; i < 64; i++) {
+        batch[i] = makeRequest(i);
+    }
+    for (auto _ : state) {
+        queue.pushBatch(batch, 64);
+        benchmark::DoNotOptimize(queue.popBatch(batch, 64));
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_QueueBatch);
+
+/**
+ * @brief Drains 64 wrapped requests with frontRun() and drop(), failing
+ *        if any of them is copied on the way out.
+ *
+ * RingBuffer takes only trivially copyable elements, so a copy cannot
+ * be counted in a copy constructor; it is caught by address instead.
+ * Every run must start at the queue's own front slot, and its elements
+ * must come out in push order.
+ */
+static void BM_QueueFrontRun(benchmark::State& state) {
+    RingBuffer<Request> queue;
+    queue.reserve(128);
+    Request batch[64];
+    // Leave the head part way through the array so every drain wraps
+    queue.pushBatch(batch, 64);
+    queue.pushBatch(batch, 40);
+    queue.popBatch(batch, 64);
+    queue.popBatch(batch, 40);
+    for (size_t i = 0; i < 64; i++) {
+        batch[i] = makeRequest(i);
+    }
+    for (auto _ : state) {
+        queue.pushBatch(batch, 64);
+        size_t next = 0;
+        const Request* run;
+        size_t taken;
+        while ((taken = queue.frontRun(run, queue.size())) > 0) {
+            if (run != &queue.front()) {
+                state.SkipWithError("frontRun() returned a copy of the queue");
+                return;
+            }
+            for (size_t b = 0; b < taken; b++, next++) {
+                if (run[b].getArrivalTime() != static_cast<int>(next)) {
+                    state.SkipWithError("frontRun() returned requests out of order");
+                    return;
+                }
+            }
+            benchmark::DoNotOptimize(run);
+            queue.drop(taken);
+        }
+        if (next != 64) {
+            state.SkipWithError("frontRun() and drop() lost requests");
+            return;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_QueueFrontRun);
+
+/**
+ * @brief N producer threads pushing into an ingress queue while this
+ *        thread drains it, failing unless every request comes out once.
+ *
+ * Producers retry a full queue until their share of the requests is in.
+ * The drain mirrors LoadBalancer::drainIngress(): 256 requests per batch
+ * and at most one queue capacity per cycle. Each request carries its
+ * index as its arrival time, so a duplicate or a missing request is
+ * caught.
+ */
+static void BM_IngressProducers(benchmark::State& state) {
+    const size_t total = 1 << 16;
+    const size_t batchSize = 256;
+    size_t producers = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> seen(total);
+    std::vector<Request> batch(batchSize);
+
+    for (auto _ : state) {
+        MpmcQueue<Request> queue(1024);
+        std::fill(seen.begin(), seen.end(), 0);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; p++) {
+            threads.emplace_back([&queue, p, producers, total] {
+                for (size_t id = p; id < total; id += producers) {
+                    Request req = makeRequest(id);
+                    while (!queue.tryPush(req)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        size_t drained = 0;
+        bool duplicate = false;
+        while (drained < total) {
+            size_t budget = queue.capacity();
+            size_t taken;
+            while (budget > 0 && (taken = queue.tryPopBatch(batch.data(), std::min(budget, batchSize))) > 0) {
+                for (size_t b = 0; b < taken; b++) {
+                    size_t id = static_cast<size_t>(batch[b].getArrivalTime());
+                    duplicate |= id >= total || seen[id]++ != 0;
+                }
+                drained += taken;
+                budget -= taken;
+            }
+            if (budget == queue.capacity()) {
+                std::this_thread::yield();
+            }
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        if (duplicate || !queue.empty()) {
+            state.SkipWithError("ingress queue did not drain every request exactly once");
+            return;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * total);
+}
+BENCHMARK(BM_IngressProducers)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+/**
+ * @brief N producer threads calling LoadBalancer::submit(), then a run
+ *        that drains them, failing unless every request is accounted for.
+ *
+ * Generated arrivals and the initial queue are off, so each submitted
+ * request must end up processed, blocked or still queued exactly once.
+ */
+static void BM_IngressSubmit(benchmark::State& state) {
+    const size_t total = 1 << 14;
+    size_t producers = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        SimConfig config = quietConfig(100, 1000);
+        config.arrivalProbability = 0.0;
+        config.initialQueuePerServer = 0;
+        LoadBalancer lb(config);
+        lb.setConsole(nullptr);
+        lb.enableIngress(total);
+        state.ResumeTiming();
+
+        std::atomic<size_t> rejected(0);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; p++) {
+            threads.emplace_back([&lb, &rejected, p, producers, total] {
+                for (size_t id = p; id < total; id += producers) {
+                    uint32_t ip = static_cast<uint32_t>(id * 2654435761u);
+                    if (!lb.submit(Request(ip, ip, id & 1, 12 + id % 29, 0))) {
+                        rejected.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        lb.Run();
+
+        state.PauseTiming();
+        RunSummary summary = lb.getSummary();
+        size_t accounted = static_cast<size_t>(summary.processed) + summary.blocked + summary.endingQueue;
+        if (rejected.load() != 0 || accounted != total) {
+            state.SkipWithError("submitted requests were lost or counted twice");
+            return;
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * total);
+}
+BENCHMARK(BM_IngressSubmit)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Fills a pool with N servers that stay busy for the whole benchmark.
+ */
+static void fillPool(ServerPool& pool, int64_t servers) {
+    for (int64_t i = 0; i < servers; i++) {
+        pool.add(1.0);
+        pool[i].processRequest(Request(0, 0, false, 1 << 30, 0));
+    }
+}
+
+/**
+ * @brief One cycle of the vectorized ServerPool::tick() over N servers.
+ */
+static void BM_ServerPoolTick(benchmark::State& state) {
+    ServerPool pool;
+    fillPool(pool, state.range(0));
+    std::vector<uint64_t> finished(pool.blocks());
+    for (auto _ : state) {
+        pool.tick(0, pool.blocks(), finished.data());
+        benchmark::DoNotOptimize(finished.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ServerPoolTick)->Arg(1000)->Arg(100000);
+
+/**
+ * @brief One cycle of WebServer::handleRequest() called per server.
+ */
+static void BM_HandleRequestLoop(benchmark::State& state) {
+    ServerPool pool;
+    fillPool(pool, state.range(0));
+    for (auto _ : state) {
+        for (size_t i = 0; i < pool.size(); i++) {
+            pool[i].handleRequest();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HandleRequestLoop)->Arg(1000)->Arg(100000);
+
+/**
+ * @brief First-idle dispatch: take the lowest idle server and release one.
+ *
+ * Half the servers are idle; each iteration marks the next idle server
+ * busy and a spread-out busy one idle, so the idle count stays constant.
+ */
+static void BM_DispatchFirstIdle(benchmark::State& state) {
+    IdleServerSet idle;
+    size_t n = static_cast<size_t>(state.range(0));
+    for (size_t i = 0; i < n; i++) {
+        idle.pushBack(i % 2 == 0);
+    }
+    size_t cursor = 0;
+    size_t release = 1;
+    for (auto _ : state) {
+        size_t server = idle.findNext(cursor);
+        if (server == IdleServerSet::NONE) {
+            server = idle.findFirst();
+        }
+        idle.markBusy(server);
+        cursor = server + 1;
+        while (idle.isIdle(release)) {
+            release = (release + 7919) % n;
+        }
+        idle.markIdle(release);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DispatchFirstIdle)->Arg(1000)->Arg(100000);
+
+/**
+ * @brief Dispatch policy select() plus the update() for the chosen server.
+ *
+ * Every server can hold four requests; a chosen server's load goes up
+ * by one and a random server's goes down by one, keeping the total load
+ * steady.
+ */
+static void BM_DispatchPolicy(benchmark::State& state, const char* name) {
+    size_t n = static_cast<size_t>(state.range(0));
+    std::unique_ptr<DispatchPolicy> policy = DispatchPolicy::create(name, 3);
+    policy->resize(n);
+    std::vector<ServerLoad> loads(n);
+    for (size_t i = 0; i < n; i++) {
+        loads[i] = ServerLoad{i % 4, 4, static_cast<int>(i % 97), 1.0 + i % 3};
+        policy->update(i, loads[i]);
+    }
+
+    Random rng(4);
+    for (auto _ : state) {
+        size_t server = policy->select();
+        if (server != DispatchPolicy::NONE) {
+            loads[server].outstanding++;
+            loads[server].drainCycle += 13;
+            policy->update(server, loads[server]);
+        }
+        size_t other = rng.uniform(static_cast<uint32_t>(n));
+        if (loads[other].outstanding > 0) {
+            loads[other].outstanding--;
+            policy->update(other, loads[other]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_DispatchPolicy, round_robin, "round-robin")->Arg(1000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_DispatchPolicy, least_work, "least-work")->Arg(1000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_DispatchPolicy, p2c, "p2c")->Arg(1000)->Arg(100000);
+BENCHMARK_CAPTURE(BM_DispatchPolicy, weighted, "weighted")->Arg(1000)->Arg(100000);
+
+/**
+ * @brief Counts the allocations made by Run() for one simulation.
+ *
+ * @param dispatch Dispatch policy name
+ * @param eventDriven true for the event-driven scheduler
+ * @param cycles Clock cycles to simulate
+ * @return Calls to operator new made by Run() on this thread
+ */
+static uint64_t runAllocations(const char* dispatch, bool eventDriven, int cycles) {
+    SimConfig config = quietConfig(100, cycles);
+    config.dispatch = dispatch;
+    config.serverQueue = 2;
+    config.eventDriven = eventDriven;
+    LoadBalancer lb(config);
+    lb.setConsole(nullptr);
+    uint64_t before = allocationCount;
+    lb.Run();
+    return allocationCount - before;
+}
+
+/**
+ * @brief A 20000-cycle run, failing if it allocates noticeably more than
+ *        a 2000-cycle one.
+ *
+ * Run() allocates a handful of times for setup and the end-of-run
+ * summary, whose text may need a buffer more when its numbers are
+ * longer. An allocation made every cycle, or every few cycles, adds
+ * thousands.
+ */
+static void BM_RunAllocations(benchmark::State& state, const char* dispatch) {
+    const uint64_t slack = 4;
+    bool eventDriven = state.range(0) != 0;
+    uint64_t baseline = runAllocations(dispatch, eventDriven, 2000);
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        allocations = runAllocations(dispatch, eventDriven, 20000);
+        if (allocations > baseline + slack) {
+            state.SkipWithError("Run() allocates in steady state");
+            return;
+        }
+    }
+    state.counters["allocations"] = static_cast<double>(allocations);
+}
+BENCHMARK_CAPTURE(BM_RunAllocations, first_idle, "first-idle")
+    ->ArgName("event")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_RunAllocations, p2c, "p2c")
+    ->ArgName("event")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief A whole simulation of N servers, ticked or event-driven.
+ *
+ * Construction, which fills the initial queue, is not timed. The cycle
+ * count shrinks as the pool grows so each run takes similar time.
+ */
+static void BM_Simulation(benchmark::State& state) {
+    int servers = static_cast<int>(state.range(0));
+    int cycles = servers >= 100000 ? 500 : servers >= 1000 ? 20000 : 100000;
+    double simulatedCycles = 0;
+    double processed = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        SimConfig config = quietConfig(servers, cycles);
+        config.eventDriven = state.range(1) != 0;
+        LoadBalancer lb(config);
+        lb.setConsole(nullptr);
+        state.ResumeTiming();
+
+        lb.Run();
+
+        state.PauseTiming();
+        RunSummary summary = lb.getSummary();
+        simulatedCycles += summary.cycles;
+        processed += summary.processed;
+        state.ResumeTiming();
+    }
+
+    state.counters["cycles_per_sec"] = benchmark::Counter(simulatedCycles, benchmark::Counter::kIsRate);
+    state.counters["requests_per_sec"] = benchmark::Counter(processed, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Simulation)
+    ->ArgNames({"servers", "event"})
+    ->ArgsProduct({{10, 1000, 100000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
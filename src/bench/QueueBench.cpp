@@ -0,0 +1,150 @@
+/**
+ * @file QueueBench.cpp
+ * @brief Microbenchmark comparing RingBuffer with std::queue for Requests.
+ *
+ * Measures three access patterns seen in the simulation: filling a large
+ * backlog and draining it, a steady state with a standing backlog, and
+ * batch draining to idle servers.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <queue>
+#include <vector>
+#include "../Request.h"
+#include "../RingBuffer.h"
+
+/** Keeps the optimizer from discarding benchmark results */
+static volatile uint64_t sink;
+
+/**
+ * @brief Times a callable and returns nanoseconds per operation.
+ *
+ * @param ops Number of operations the callable performs
+ * @param fn Benchmark body
+ * @return Nanoseconds per operation
+ */
+template <typename Fn>
+static double timePerOp(size_t ops, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+/**
+ * @brief Builds a request whose fields depend on i.
+ */
+static Request makeRequest(size_t i) {
+    return Request(static_cast<uint32_t>(i * 2654435761u),
+                   static_cast<uint32_t>(i), i & 1, 12 + i % 29,
+                   static_cast<int>(i));
+}
+
+/**
+ * @brief Pushes n requests then pops them all.
+ */
+template <typename Queue>
+static double fillDrain(size_t n) {
+    return timePerOp(2 * n, [n] {
+        Queue q;
+        for (size_t i = 0; i < n; i++) {
+            q.push(makeRequest(i));
+        }
+        uint64_t total = 0;
+        while (!q.empty()) {
+            total += q.front().getProcessingTime();
+            q.pop();
+        }
+        sink = total;
+    });
+}
+
+/**
+ * @brief Pushes n requests into a pre-reserved RingBuffer then pops them all.
+ *
+ * Matches populateReqQueue(), which knows the backlog size up front.
+ */
+static double fillDrainReserved(size_t n) {
+    return timePerOp(2 * n, [n] {
+        RingBuffer<Request> q;
+        q.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            q.push(makeRequest(i));
+        }
+        uint64_t total = 0;
+        while (!q.empty()) {
+            total += q.front().getProcessingTime();
+            q.pop();
+        }
+        sink = total;
+    });
+}
+
+/**
+ * @brief Keeps a standing backlog and alternates push/pop.
+ */
+template <typename Queue>
+static double steadyState(size_t backlog, size_t n) {
+    Queue q;
+    for (size_t i = 0; i < backlog; i++) {
+        q.push(makeRequest(i));
+    }
+    return timePerOp(2 * n, [&q, n] {
+        uint64_t total = 0;
+        for (size_t i = 0; i < n; i++) {
+            q.push(makeRequest(i));
+            total += q.front().getIpIn();
+            q.pop();
+        }
+        sink = total;
+    });
+}
+
+/**
+ * @brief Drains a backlog 64 requests at a time with popBatch().
+ */
+static double batchDrain(size_t n) {
+    std::vector<Request> source;
+    for (size_t i = 0; i < n; i++) {
+        source.push_back(makeRequest(i));
+    }
+    return timePerOp(2 * n, [&source, n] {
+        RingBuffer<Request> q;
+        q.pushBatch(source.data(), n);
+        Request batch[64];
+        uint64_t total = 0;
+        size_t taken;
+        while ((taken = q.popBatch(batch, 64)) > 0) {
+            for (size_t b = 0; b < taken; b++) {
+                total += batch[b].getProcessingTime();
+            }
+        }
+        sink = total;
+    });
+}
+
+/**
+ * @brief Runs every pattern and prints ns/op for both queues.
+ *
+ * @return Exit status of the program.
+ */
+int main() {
+    const size_t n = 1000000;
+
+    std::printf("%-28s %12s %12s\n", "pattern (ns/op)", "std::queue", "RingBuffer");
+    std::printf("%-28s %12.2f %12.2f\n", "fill+drain 1M",
+                fillDrain<std::queue<Request>>(n),
+                fillDrain<RingBuffer<Request>>(n));
+    std::printf("%-28s %12s %12.2f\n", "fill+drain 1M, reserved", "-",
+                fillDrainReserved(n));
+    std::printf("%-28s %12.2f %12.2f\n", "steady, backlog 200",
+                steadyState<std::queue<Request>>(200, n),
+                steadyState<RingBuffer<Request>>(200, n));
+    std::printf("%-28s %12.2f %12.2f\n", "steady, backlog 100k",
+                steadyState<std::queue<Request>>(100000, n),
+                steadyState<RingBuffer<Request>>(100000, n));
+    std::printf("%-28s %12s %12.2f\n", "batch push+drain 1M", "-",
+                batchDrain(n));
+    return 0;
+}
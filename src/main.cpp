@@ -1,46 +1,167 @@
 /**
  * @file main.cpp
  * @brief Implementation of the user facing logic that runs loadbalancer.
- * This file contains the main function which prompts the user for
- * simulation parameters, initializes the LoadBalancer, and starts
- * the simulation.
+ * This file contains the main function which reads simulation
+ * parameters from the command line, a config file or the user,
+ * initializes the LoadBalancer, and starts the simulation.
  */
 #include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
 #include "LoadBalancer.h"
+#include "Sweep.h"
+#include "TraceWriter.h"
+#include "TimeSeriesReader.h"
+
+/**
+ * @brief Prints command-line usage.
+ *
+ * @param program Name the program was started as.
+ */
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program
+              << " [--config FILE] [--jobs N] [--event] [--SETTING VALUE]...\n"
+              << "       " << program << " --convert-trace CSV TRACE\n"
+              << "       " << program << " --export-series SERIES CSV\n\n"
+              << "Without --servers and --cycles (and no scenarios in the config file)\n"
+              << "the missing values are read interactively.\n\n"
+              << "A config file holds 'setting = value' lines. Lines before the first\n"
+              << "[name] header apply to every run; each [name] section is a separate\n"
+              << "scenario run in this process. Command-line settings override the\n"
+              << "file's global lines but not its scenario sections.\n\n"
+              << "--jobs N runs up to N scenarios at once on a work-stealing thread\n"
+              << "pool (0 = one per hardware thread) and prints only the final table.\n\n"
+              << "--convert-trace turns a CSV capture with lines\n"
+              << "'arrival,ip_in,ip_out,streaming,duration' (sorted by arrival) into a\n"
+              << "binary trace for the trace setting.\n\n"
+              << "--export-series writes a time series from the series setting as CSV\n"
+              << "with one column per field.\n\n"
+              << "Settings:\n" << SimConfig::help();
+}
+
+/**
+ * @brief Prompts for a positive integer until one is entered.
+ *
+ * @param prompt Text shown before the first attempt.
+ * @param retry Text shown after an invalid entry.
+ * @return The value entered.
+ */
+static int promptPositive(const char* prompt, const char* retry) {
+    int value = 0;
+    std::cout << prompt;
+    std::cin >> value;
+
+    while (value < 1) {
+        if (!std::cin) {
+            std::exit(1);
+        }
+        std::cout << retry;
+        std::cin >> value;
+    }
+    return value;
+}
 
 /**
  * @brief Entry point for the load balancer simulation.
  *
- * Prompts the user for simulation parameters, initializes
- * the load balancer, and runs the simulation for the
- * specified number of clock cycles.
+ * Builds the configuration from defaults, the optional config file
+ * and command-line settings, prompts for the server and cycle counts
+ * if they are still missing, and runs every scenario. When more than
+ * one run was made, the final counters are tabulated.
  *
+ * @param argc Number of command-line arguments.
+ * @param argv Command-line arguments.
  * @return Exit status of the program.
  */
-int main() {
-    int numServers;
-    int runTime;
+int main(int argc, char* argv[]) {
+    SimConfig defaults;
+    defaults.seed = static_cast<uint64_t>(std::time(nullptr));
+    std::vector<std::pair<std::string, std::string>> cliSettings;
+    std::string configPath;
+    size_t jobs = 1;
 
-    std::cout << "Enter initial number of web servers: ";
-    std::cin >> numServers;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--convert-trace" && i + 2 < argc) {
+            uint64_t records = 0;
+            std::string error;
+            if (!convertCsvTrace(argv[i + 1], argv[i + 2], records, error)) {
+                std::cerr << "Error: " << error << "\n";
+                return 1;
+            }
+            std::cout << "Wrote " << records << " requests to " << argv[i + 2] << "\n";
+            return 0;
+        } else if (arg == "--export-series" && i + 2 < argc) {
+            uint64_t rows = 0;
+            std::string error;
+            if (!exportSeriesCsv(argv[i + 1], argv[i + 2], rows, error)) {
+                std::cerr << "Error: " << error << "\n";
+                return 1;
+            }
+            std::cout << "Wrote " << rows << " rows to " << argv[i + 2] << "\n";
+            return 0;
+        } else if (arg == "--event") {
+            cliSettings.emplace_back("event", "true");
+        } else if (arg == "--config" && i + 1 < argc) {
+            configPath = argv[++i];
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg.compare(0, 2, "--") == 0 && i + 1 < argc) {
+            cliSettings.emplace_back(arg.substr(2), argv[++i]);
+        } else {
+            std::cerr << "Error: unexpected argument '" << arg << "'\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
-    while (numServers < 1) {
-        std::cout << "Number of servers must be at least 1. Try again: ";
-        std::cin >> numServers;
+    std::vector<ConfigSection> sections(1);
+    std::string error;
+    if (!configPath.empty() && !readConfigFile(configPath, sections, error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
     }
 
-    std::cout << "Enter number of clock cycles to run the load balancer: ";
-    std::cin >> runTime;
+    std::vector<SweepJob> sweep;
+    if (!buildSweep(defaults, sections, cliSettings, sweep, error)) {
+        std::cerr << "Error: " << error << "\n";
+        return 1;
+    }
 
-    while (runTime < 1) {
-        std::cout << "Runtime must be at least 1. Try again: ";
-        std::cin >> runTime;
+    if (sweep.size() == 1) {
+        SimConfig& config = sweep[0].config;
+        if (config.servers < 1 && config.serverClasses.empty() && config.restorePath.empty()) {
+            config.servers = promptPositive("Enter initial number of web servers: ",
+                                            "Number of servers must be at least 1. Try again: ");
+        }
+        if (config.cycles < 1) {
+            config.cycles = promptPositive("Enter number of clock cycles to run the load balancer: ",
+                                           "Runtime must be at least 1. Try again: ");
+        }
     }
 
-    std::cout << "\nStarting load balancer...\n\n";
+    std::vector<SweepResult> results = runSweep(sweep, jobs);
 
-    LoadBalancer lb(numServers, runTime);
-    lb.Run();
+    int failures = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].ok) {
+            failures++;
+            if (sweep.size() == 1) {
+                std::cerr << "Error: " << results[i].error << "\n";
+            }
+        }
+    }
+    if (sweep.size() > 1) {
+        printSweepTable(std::cout, sweep, results);
+    }
+    if (failures > 0) {
+        return 1;
+    }
 
     std::cout << "\nLoad Balancer completed.\n";
 